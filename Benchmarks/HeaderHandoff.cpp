@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ResponseHeaders.h"
+#include <AK/Format.h>
+#include <AK/JsonArray.h>
+#include <LibCore/ArgsParser.h>
+#include <LibMain/Main.h>
+#include <stdlib.h>
+
+// Counts the allocations it takes to turn a libsoup response's headers into the map LibWeb is handed, and times it,
+// for header_map_from_soup() and for the header-by-header conversion it replaced.
+
+// NOTE: Everything in AK allocates through malloc(), so that's where allocations are counted. This leans on glibc
+//       letting a program interpose malloc() and still reach its own through __libc_malloc() and friends.
+#ifdef __GLIBC__
+static bool s_counting_allocations = false;
+static size_t s_allocation_count = 0;
+static size_t s_allocated_bytes = 0;
+
+extern "C" {
+
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+
+void* malloc(size_t size) __THROW
+{
+    if (s_counting_allocations) {
+        ++s_allocation_count;
+        s_allocated_bytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW
+{
+    if (s_counting_allocations) {
+        ++s_allocation_count;
+        s_allocated_bytes += count * size;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) __THROW
+{
+    if (s_counting_allocations) {
+        ++s_allocation_count;
+        s_allocated_bytes += size;
+    }
+    return __libc_realloc(pointer, size);
+}
+
+}
+#endif
+
+using HeaderMap = Ladybird::HttpCache::HeaderMap;
+
+// What did_finish_reading() did before header_map_from_soup(), kept as it was.
+static HeaderMap header_map_before(SoupMessageHeaders* http_response_headers)
+{
+    HeaderMap response_headers;
+    Vector<DeprecatedString> set_cookie_headers;
+
+    SoupMessageHeadersIter iter;
+    char const *c_name, *c_value;
+
+    soup_message_headers_iter_init(&iter, http_response_headers);
+    while (soup_message_headers_iter_next(&iter, &c_name, &c_value)) {
+        auto name = DeprecatedString(c_name);
+        auto value = DeprecatedString(c_value);
+        if (name.equals_ignoring_ascii_case("set-cookie"sv)) {
+            set_cookie_headers.append(value);
+        } else {
+            response_headers.set(name, value);
+        }
+    }
+
+    if (!set_cookie_headers.is_empty()) {
+        response_headers.set("set-cookie"sv, JsonArray { set_cookie_headers }.to_deprecated_string());
+    }
+    return response_headers;
+}
+
+struct Header {
+    char const* name;
+    char const* value;
+};
+
+// Roughly what a big site sends back with its front page.
+static constexpr Header s_response_headers[] = {
+    { "Date", "Mon, 17 Jul 2023 12:34:56 GMT" },
+    { "Content-Type", "text/html; charset=utf-8" },
+    { "Content-Length", "48213" },
+    { "Connection", "keep-alive" },
+    { "Cache-Control", "private, max-age=0, must-revalidate" },
+    { "Expires", "-1" },
+    { "ETag", "W/\"bc4d-2c1f9a3e7b\"" },
+    { "Last-Modified", "Mon, 17 Jul 2023 12:00:00 GMT" },
+    { "Vary", "Accept-Encoding" },
+    { "Vary", "Cookie" },
+    { "Strict-Transport-Security", "max-age=31536000; includeSubDomains; preload" },
+    { "Content-Security-Policy", "default-src 'self'; script-src 'self' 'nonce-4AEemGb0xJptoIGFP3Nd' https://static.example.com; img-src * data:" },
+    { "X-Content-Type-Options", "nosniff" },
+    { "X-Frame-Options", "SAMEORIGIN" },
+    { "Referrer-Policy", "strict-origin-when-cross-origin" },
+    { "Permissions-Policy", "interest-cohort=()" },
+    { "Server", "nginx" },
+    { "Alt-Svc", "h3=\":443\"; ma=86400" },
+    { "Set-Cookie", "session=8f14e45fceea167a5a36dedd4bea2543; Path=/; Secure; HttpOnly; SameSite=Lax" },
+    { "Set-Cookie", "consent=pending; Path=/; Max-Age=31536000; Secure" },
+    { "Set-Cookie", "ab_bucket=17; Path=/; Max-Age=2592000" },
+    { "X-Request-Id", "5d41402abc4b2a76b9719d911017c592" },
+};
+
+struct Measurement {
+    size_t allocations { 0 };
+    size_t bytes { 0 };
+    double microseconds_per_call { 0 };
+};
+
+template<typename Callback>
+static Measurement measure(size_t iterations, Callback callback)
+{
+    Measurement measurement;
+
+    // NOTE: The first call is only there to get any lazily set up state (libsoup's or ours) out of the count.
+    (void)callback();
+
+#ifdef __GLIBC__
+    s_allocation_count = 0;
+    s_allocated_bytes = 0;
+    s_counting_allocations = true;
+    {
+        auto headers = callback();
+        s_counting_allocations = false;
+    }
+    measurement.allocations = s_allocation_count;
+    measurement.bytes = s_allocated_bytes;
+#endif
+
+    auto start = g_get_monotonic_time();
+    for (size_t i = 0; i < iterations; ++i) {
+        auto headers = callback();
+        VERIFY(!headers.is_empty());
+    }
+    measurement.microseconds_per_call = static_cast<double>(g_get_monotonic_time() - start) / iterations;
+    return measurement;
+}
+
+static void report(StringView name, Measurement const& measurement)
+{
+#ifdef __GLIBC__
+    outln("{:22}: {:4} allocations, {:6} bytes, {:.3}us per call", name, measurement.allocations, measurement.bytes, measurement.microseconds_per_call);
+#else
+    outln("{:22}: {:.3}us per call", name, measurement.microseconds_per_call);
+#endif
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    size_t iterations = 100'000;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Count the allocations of handing a response's headers over to LibWeb.");
+    args_parser.add_option(iterations, "Times to convert the headers when timing", "iterations", 'i', "count");
+    args_parser.parse(arguments);
+
+    if (iterations == 0)
+        iterations = 1;
+
+    auto* soup_headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    for (auto const& header : s_response_headers)
+        soup_message_headers_append(soup_headers, header.name, header.value);
+
+    // NOTE: The two only differ in what they do with repeated fields: the old one kept the last, the new one combines them.
+    auto before = header_map_before(soup_headers);
+    auto after = Ladybird::header_map_from_soup(soup_headers);
+    VERIFY(before.get("Set-Cookie"sv) == after.get("Set-Cookie"sv));
+    VERIFY(before.size() == after.size());
+
+#ifndef __GLIBC__
+    outln("Counting allocations needs glibc, only timing.");
+#endif
+
+    report("header-by-header"sv, measure(iterations, [&] { return header_map_before(soup_headers); }));
+    report("header_map_from_soup"sv, measure(iterations, [&] { return Ladybird::header_map_from_soup(soup_headers); }));
+
+    soup_message_headers_unref(soup_headers);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "KeyTranslation.h"
+#include <AK/Format.h>
+#include <LibCore/ArgsParser.h>
+#include <LibMain/Main.h>
+#include <gdk/gdk.h>
+
+// Times translate_keyval() against the linear scan it replaced, over a stream of keyvals that looks like someone typing:
+// mostly letters, with digits, punctuation, modifiers, navigation, keypad and function keys, and a few we don't know.
+
+static constexpr unsigned s_typed_keyvals[] = {
+    GDK_KEY_h, GDK_KEY_e, GDK_KEY_l, GDK_KEY_l, GDK_KEY_o, GDK_KEY_space, GDK_KEY_w, GDK_KEY_o, GDK_KEY_r, GDK_KEY_l, GDK_KEY_d,
+    GDK_KEY_Shift_L, GDK_KEY_T, GDK_KEY_h, GDK_KEY_e, GDK_KEY_space, GDK_KEY_q, GDK_KEY_u, GDK_KEY_i, GDK_KEY_c, GDK_KEY_k,
+    GDK_KEY_comma, GDK_KEY_period, GDK_KEY_exclam, GDK_KEY_question, GDK_KEY_apostrophe, GDK_KEY_quotedbl, GDK_KEY_parenleft,
+    GDK_KEY_0, GDK_KEY_1, GDK_KEY_2, GDK_KEY_9, GDK_KEY_BackSpace, GDK_KEY_BackSpace, GDK_KEY_Return, GDK_KEY_Tab,
+    GDK_KEY_Control_L, GDK_KEY_c, GDK_KEY_Control_L, GDK_KEY_v, GDK_KEY_Alt_L, GDK_KEY_ISO_Level3_Shift, GDK_KEY_Super_L,
+    GDK_KEY_Left, GDK_KEY_Right, GDK_KEY_Up, GDK_KEY_Down, GDK_KEY_Page_Down, GDK_KEY_Home, GDK_KEY_End, GDK_KEY_Escape,
+    GDK_KEY_KP_1, GDK_KEY_KP_Add, GDK_KEY_KP_Enter, GDK_KEY_F5, GDK_KEY_F12, GDK_KEY_Z, GDK_KEY_z, GDK_KEY_dead_circumflex,
+    // Not in the mapping list: both lookups have to get all the way to "no".
+    GDK_KEY_adiaeresis, GDK_KEY_Cyrillic_a, GDK_KEY_Greek_alpha, GDK_KEY_EuroSign, GDK_KEY_XF86AudioPlay, 0x1000101,
+};
+
+static KeyCode translate_keyval_by_scanning(unsigned keyval)
+{
+    for (auto const& mapping : Ladybird::keyval_mappings()) {
+        if (mapping.gdk_key == keyval)
+            return mapping.serenity_key;
+    }
+    return Key_Invalid;
+}
+
+template<typename Callback>
+static void time_lookups(StringView name, size_t iterations, Callback callback)
+{
+    // NOTE: Stops the compiler from deciding the results were never needed.
+    static u32 volatile sink;
+    u32 checksum = 0;
+
+    auto start = g_get_monotonic_time();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (auto keyval : s_typed_keyvals)
+            checksum += callback(keyval);
+    }
+    auto elapsed_us = g_get_monotonic_time() - start;
+    sink = checksum;
+
+    auto lookups = iterations * array_size(s_typed_keyvals);
+    outln("{:24}: {} lookups in {:.3}ms, {:.2}ns each",
+        name, lookups, elapsed_us / 1000.0, elapsed_us * 1000.0 / lookups);
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    size_t iterations = 1'000'000;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how long translating a GDK keyval to a KeyCode takes.");
+    args_parser.add_option(iterations, "Times to go through the keyval stream", "iterations", 'i', "count");
+    args_parser.parse(arguments);
+
+    // NOTE: The tables have to agree with the list they're built from, or there's nothing to compare.
+    for (auto const& mapping : Ladybird::keyval_mappings())
+        VERIFY(Ladybird::translate_keyval(mapping.gdk_key) == translate_keyval_by_scanning(mapping.gdk_key));
+    for (auto keyval : s_typed_keyvals)
+        VERIFY(Ladybird::translate_keyval(keyval) == translate_keyval_by_scanning(keyval));
+
+    time_lookups("translate_keyval"sv, iterations, [](unsigned keyval) { return Ladybird::translate_keyval(keyval); });
+    time_lookups("linear scan"sv, iterations, [](unsigned keyval) { return translate_keyval_by_scanning(keyval); });
+    // NOTE: The other per-key lookup on the way to WebContent, for scale.
+    time_lookups("gdk_keyval_to_unicode"sv, iterations, [](unsigned keyval) { return gdk_keyval_to_unicode(keyval); });
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "EventLoopImplementationGLib.h"
+#include "WebSocketClientManagerLadybird.h"
+#include <AK/ByteBuffer.h>
+#include <AK/Format.h>
+#include <AK/URL.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/EventLoop.h>
+#include <LibMain/Main.h>
+#include <glibmm/init.h>
+#include <libsoup/soup.h>
+
+// Pushes messages through a WebSocketLadybird in both directions, against a libsoup server in the same process.
+//   receive: the server sends --messages messages as fast as it can, timed until the client has seen the last one.
+//   send: the client sends as many, timed until the server has seen the last one and said so.
+
+namespace {
+
+enum class Phase {
+    Connecting,
+    Receiving,
+    Sending,
+};
+
+struct Benchmark {
+    size_t message_count { 20'000 };
+    size_t message_size { 1024 };
+    bool text { false };
+
+    ByteBuffer payload;
+    GBytes* payload_bytes { nullptr };
+
+    SoupWebsocketConnection* server_connection { nullptr };
+    size_t server_received { 0 };
+
+    RefPtr<Web::WebSockets::WebSocketClientSocket> client;
+    Phase phase { Phase::Connecting };
+    size_t client_received { 0 };
+    size_t client_received_bytes { 0 };
+    gint64 phase_start { 0 };
+
+    SoupWebsocketDataType data_type() const { return text ? SOUP_WEBSOCKET_DATA_TEXT : SOUP_WEBSOCKET_DATA_BINARY; }
+};
+
+}
+
+static void report(StringView name, Benchmark const& benchmark)
+{
+    auto elapsed_us = g_get_monotonic_time() - benchmark.phase_start;
+    auto seconds = static_cast<double>(elapsed_us) / 1'000'000;
+    auto total_bytes = static_cast<double>(benchmark.message_count * benchmark.message_size);
+    outln("{:8}: {} messages of {} bytes in {:.3}s, {:.0} messages/s, {:.1} MiB/s",
+        name, benchmark.message_count, benchmark.message_size, seconds,
+        benchmark.message_count / seconds, total_bytes / MiB / seconds);
+}
+
+static void server_did_receive_message(SoupWebsocketConnection* connection, gint, GBytes*, gpointer user_data)
+{
+    auto& benchmark = *static_cast<Benchmark*>(user_data);
+
+    if (benchmark.phase == Phase::Receiving) {
+        // NOTE: libsoup has no backpressure to speak of, so all of these are queued up front. Keep --messages * --size sensible.
+        for (size_t i = 0; i < benchmark.message_count; ++i)
+            soup_websocket_connection_send_message(connection, benchmark.data_type(), benchmark.payload_bytes);
+        return;
+    }
+
+    if (++benchmark.server_received == benchmark.message_count)
+        soup_websocket_connection_send_text(connection, "done");
+}
+
+static void server_did_connect(SoupServer*, SoupServerMessage*, char const*, SoupWebsocketConnection* connection, gpointer user_data)
+{
+    auto& benchmark = *static_cast<Benchmark*>(user_data);
+    benchmark.server_connection = SOUP_WEBSOCKET_CONNECTION(g_object_ref(connection));
+    soup_websocket_connection_set_max_incoming_payload_size(connection, 0);
+    g_signal_connect(connection, "message", G_CALLBACK(server_did_receive_message), &benchmark);
+}
+
+static ErrorOr<void> send_from_client(Benchmark& benchmark)
+{
+    for (size_t i = 0; i < benchmark.message_count; ++i) {
+        // NOTE: LibWeb hands every message over in a buffer of its own, so this copy is part of what's measured.
+        if (benchmark.text)
+            benchmark.client->send(StringView { benchmark.payload.bytes() });
+        else
+            benchmark.client->send(TRY(ByteBuffer::copy(benchmark.payload)), false);
+    }
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Benchmark benchmark;
+    bool disable_deflate = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure WebSocket message throughput through libsoup.");
+    args_parser.add_option(benchmark.message_count, "Messages to send each way", "messages", 'n', "count");
+    args_parser.add_option(benchmark.message_size, "Size of each message in bytes", "size", 's', "bytes");
+    args_parser.add_option(benchmark.text, "Send text messages instead of binary ones", "text", 't');
+    args_parser.add_option(disable_deflate, "Don't negotiate permessage-deflate", "no-deflate", 0);
+    args_parser.parse(arguments);
+
+    if (benchmark.message_count == 0 || benchmark.message_size == 0) {
+        warnln("Need at least one message of at least one byte");
+        return 1;
+    }
+
+    Glib::init();
+
+    Core::EventLoopManager::install(*new Ladybird::EventLoopManagerGLib);
+    Core::EventLoop event_loop;
+
+    // NOTE: Printable ASCII from a fixed LCG, so text messages are valid UTF-8 and deflate has something to do without it being trivial.
+    benchmark.payload = TRY(ByteBuffer::create_uninitialized(benchmark.message_size));
+    u32 seed = 0x2545f491;
+    for (auto& byte : benchmark.payload.bytes()) {
+        seed = seed * 1664525 + 1013904223;
+        byte = ' ' + (seed >> 24) % ('~' - ' ' + 1);
+    }
+    benchmark.payload_bytes = g_bytes_new_static(benchmark.payload.data(), benchmark.payload.size());
+
+    auto* server = soup_server_new(nullptr, nullptr);
+    if (disable_deflate)
+        soup_server_remove_websocket_extension(server, SOUP_TYPE_WEBSOCKET_EXTENSION_DEFLATE);
+    soup_server_add_websocket_handler(server, "/", nullptr, nullptr, server_did_connect, &benchmark, nullptr);
+
+    GError* error = nullptr;
+    if (!soup_server_listen_local(server, 0, SOUP_SERVER_LISTEN_IPV4_ONLY, &error)) {
+        warnln("Failed to listen: {}", error->message);
+        g_error_free(error);
+        return 1;
+    }
+
+    auto* uris = soup_server_get_uris(server);
+    auto port = g_uri_get_port(static_cast<GUri*>(uris->data));
+    g_slist_free_full(uris, reinterpret_cast<GDestroyNotify>(g_uri_unref));
+
+    auto client_manager = Ladybird::WebSocketClientManagerLadybird::create();
+    benchmark.client = client_manager->connect(AK::URL { DeprecatedString::formatted("ws://127.0.0.1:{}/", port) }, {}, {});
+
+    int exit_code = 0;
+
+    benchmark.client->on_open = [&] {
+        benchmark.phase = Phase::Receiving;
+        benchmark.phase_start = g_get_monotonic_time();
+        benchmark.client->send("go"sv);
+    };
+
+    benchmark.client->on_message = [&](auto message) {
+        if (benchmark.phase == Phase::Receiving) {
+            ++benchmark.client_received;
+            benchmark.client_received_bytes += message.data.size();
+            if (benchmark.client_received < benchmark.message_count)
+                return;
+
+            VERIFY(benchmark.client_received_bytes == benchmark.message_count * benchmark.message_size);
+            report("receive"sv, benchmark);
+
+            benchmark.phase = Phase::Sending;
+            benchmark.phase_start = g_get_monotonic_time();
+            if (auto result = send_from_client(benchmark); result.is_error()) {
+                warnln("Failed to send: {}", result.error());
+                exit_code = 1;
+                event_loop.quit(exit_code);
+            }
+            return;
+        }
+
+        // NOTE: The only message the server sends back during the send phase is the one saying it has seen them all.
+        report("send"sv, benchmark);
+        benchmark.client->close(1000, {});
+    };
+
+    benchmark.client->on_error = [&](auto) {
+        warnln("WebSocket error");
+        exit_code = 1;
+    };
+
+    benchmark.client->on_close = [&](auto, auto, auto) {
+        event_loop.quit(exit_code);
+    };
+
+    event_loop.exec();
+
+    benchmark.client = nullptr;
+    if (benchmark.server_connection)
+        g_object_unref(benchmark.server_connection);
+    g_object_unref(server);
+    g_bytes_unref(benchmark.payload_bytes);
+
+    return exit_code;
+}
@@ -5,7 +5,7 @@ include(GNUInstallDirs)
 set(package WebEmbed)
 
 #set(webembed_applications webembed SQLServer WebContent WebDriver headless-browser)
-set(webembed_applications demo-browser SQLServer WebContent WebDriver)
+set(webembed_applications demo-browser NetworkServer SQLServer WebContent WebDriver)
 
 install(TARGETS ${webembed_applications}
   EXPORT webembedTargets
@@ -81,6 +81,11 @@ install(DIRECTORY
   COMPONENT webembed_Runtime
 )
 
+install(FILES "${RESOURCE_BUNDLE}"
+  DESTINATION "${CMAKE_INSTALL_DATADIR}/res"
+  COMPONENT webembed_Runtime
+)
+
 install(FILES
     "${SERENITY_SOURCE_DIR}/Base/home/anon/.config/BrowserAutoplayAllowlist.txt"
     "${SERENITY_SOURCE_DIR}/Base/home/anon/.config/BrowserContentFilters.txt"
@@ -0,0 +1,46 @@
+# Packs the resources we read ourselves into one GResource bundle, see src/ResourceBundle.h.
+# Fonts and emoji stay loose files, as LibGfx looks those up in directories.
+
+find_program(GLIB_COMPILE_RESOURCES glib-compile-resources REQUIRED)
+
+set(RESOURCE_BUNDLE_SOURCE_DIR "${SERENITY_SOURCE_DIR}/Base")
+set(RESOURCE_BUNDLE_XML "${CMAKE_CURRENT_BINARY_DIR}/webembed.gresource.xml")
+set(RESOURCE_BUNDLE "${CMAKE_CURRENT_BINARY_DIR}/webembed.gresource")
+
+file(GLOB RESOURCE_BUNDLE_FILES RELATIVE "${RESOURCE_BUNDLE_SOURCE_DIR}" CONFIGURE_DEPENDS
+    "${RESOURCE_BUNDLE_SOURCE_DIR}/res/themes/*.ini"
+    "${RESOURCE_BUNDLE_SOURCE_DIR}/res/html/*.html"
+    "${RESOURCE_BUNDLE_SOURCE_DIR}/res/icons/16x16/app-browser.png"
+)
+
+set(RESOURCE_BUNDLE_ENTRIES "")
+foreach (file IN LISTS RESOURCE_BUNDLE_FILES)
+    string(APPEND RESOURCE_BUNDLE_ENTRIES "    <file>${file}</file>\n")
+endforeach()
+
+# The lists we ship are found under res/ladybird, where WebContent falls back to when the user has none of their own.
+foreach (list IN ITEMS BrowserContentFilters.txt BrowserAutoplayAllowlist.txt)
+    string(APPEND RESOURCE_BUNDLE_ENTRIES "    <file alias=\"res/ladybird/${list}\">home/anon/.config/${list}</file>\n")
+    list(APPEND RESOURCE_BUNDLE_FILES "home/anon/.config/${list}")
+endforeach()
+
+file(WRITE "${RESOURCE_BUNDLE_XML}.in"
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gresources>\n"
+    "  <gresource prefix=\"/\">\n"
+    "${RESOURCE_BUNDLE_ENTRIES}"
+    "  </gresource>\n"
+    "</gresources>\n"
+)
+configure_file("${RESOURCE_BUNDLE_XML}.in" "${RESOURCE_BUNDLE_XML}" COPYONLY)
+
+list(TRANSFORM RESOURCE_BUNDLE_FILES PREPEND "${RESOURCE_BUNDLE_SOURCE_DIR}/" OUTPUT_VARIABLE RESOURCE_BUNDLE_DEPENDS)
+
+# NOTE: Nothing is compressed, so resources are served straight out of the mapped bundle.
+add_custom_command(
+    OUTPUT "${RESOURCE_BUNDLE}"
+    COMMAND "${GLIB_COMPILE_RESOURCES}" --sourcedir "${RESOURCE_BUNDLE_SOURCE_DIR}" --target "${RESOURCE_BUNDLE}" "${RESOURCE_BUNDLE_XML}"
+    DEPENDS "${RESOURCE_BUNDLE_XML}" ${RESOURCE_BUNDLE_DEPENDS}
+    VERBATIM
+)
+add_custom_target(resource_bundle${LADYBIRD_CUSTOM_TARGET_SUFFIX} ALL DEPENDS "${RESOURCE_BUNDLE}")
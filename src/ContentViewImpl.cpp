@@ -7,12 +7,19 @@
  */
 
 #include "ContentViewImpl.h"
+#include "Embed/weburischemerequestprivate.h"
 #include "HelperProcess.h"
+#include "KeyTranslation.h"
+#include "NetworkServerClient.h"
+#include "NetworkSettings.h"
+#include "ResourceBundle.h"
 #include "Utilities.h"
 #include <AK/Format.h>
 #include <AK/LexicalPath.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Types.h>
 #include <Kernel/API/KeyCode.h>
+#include <LibCore/ConfigFile.h>
 #include <LibCore/EventLoop.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
@@ -21,10 +28,13 @@
 #include <LibGfx/Rect.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibMain/Main.h>
+#include <LibWeb/Cookie/Cookie.h>
 #include <LibWeb/Crypto/Crypto.h>
 #include <LibWeb/Loader/ContentFilter.h>
 #include <LibWebView/WebContentClient.h>
+#include <cmath>
 #include <cstring>
+#include <fcntl.h>
 #include <gdkmm/general.h>
 
 #define WEB_GDK_BUTTON_FORWARD 9
@@ -44,6 +54,33 @@ signal_hide_event(ContentViewImpl *impl)
     impl->hide_event();
 }
 
+static void
+signal_gtk_theme_changed(ContentViewImpl *impl)
+{
+    impl->gtk_theme_changed();
+}
+
+static void
+signal_after_paint(ContentViewImpl *impl)
+{
+    impl->did_present_frame();
+}
+
+// NOTE: Inputs that don't lead to a paint within this long aren't what caused the next one.
+static constexpr i64 MAX_INPUT_TO_PAINT_LATENCY = 1'000'000;
+static constexpr size_t MAX_INPUTS_AWAITING_PAINT = 256;
+
+// GDK event times are in milliseconds, truncated to 32 bits, and on the monotonic clock everywhere but on some X servers.
+// Anything that doesn't look like it happened within the last second is taken to have happened just now instead.
+static i64 input_event_timestamp(guint32 event_time)
+{
+    auto now = g_get_monotonic_time();
+    auto age = static_cast<guint32>(now / 1000) - event_time;
+    if (event_time == GDK_CURRENT_TIME || age > 1000)
+        return now;
+    return now - static_cast<i64>(age) * 1000;
+}
+
 ContentViewImpl::ContentViewImpl(WebContentView *widget, StringView webdriver_content_ipc_path, WebView::EnableCallgrindProfiling enable_callgrind_profiling, WebView::UseJavaScriptBytecode use_javascript_bytecode)
         : m_webdriver_content_ipc_path(webdriver_content_ipc_path)
         , m_widget(widget)
@@ -72,9 +109,14 @@ ContentViewImpl::ContentViewImpl(WebContentView *widget, StringView webdriver_co
     g_signal_connect_swapped (m_widget, "map", G_CALLBACK (signal_show_event), this);
     g_signal_connect_swapped (m_widget, "unmap", G_CALLBACK (signal_hide_event), this);
 
+    m_gtk_settings = GTK_SETTINGS (g_object_ref (gtk_widget_get_settings(GTK_WIDGET(m_widget))));
+    g_signal_connect_swapped (m_gtk_settings, "notify::gtk-theme-name", G_CALLBACK (signal_gtk_theme_changed), this);
+    g_signal_connect_swapped (m_gtk_settings, "notify::gtk-application-prefer-dark-theme", G_CALLBACK (signal_gtk_theme_changed), this);
+
     // Event Controllers
     m_motion_controller = Gtk::EventControllerMotion::create();
     m_motion_controller->signal_motion().connect(sigc::mem_fun(*this, &ContentViewImpl::on_motion));
+    m_motion_controller->signal_leave().connect(sigc::mem_fun(*this, &ContentViewImpl::cancel_hover_prefetch));
     gtk_widget_add_controller(GTK_WIDGET(m_widget), GTK_EVENT_CONTROLLER (m_motion_controller->gobj()));
 
     m_key_controller = Gtk::EventControllerKey::create();
@@ -88,10 +130,51 @@ ContentViewImpl::ContentViewImpl(WebContentView *widget, StringView webdriver_co
     m_click_gesture->signal_released().connect(sigc::mem_fun(*this, &ContentViewImpl::on_release), false);
     gtk_widget_add_controller(GTK_WIDGET(m_widget), GTK_EVENT_CONTROLLER (m_click_gesture->gobj()));
 
+    // NOTE: We scroll ourselves rather than leaving it to the scrolled window, so we can move the frame we already have straight away.
+    m_scroll_controller = Gtk::EventControllerScroll::create();
+    m_scroll_controller->set_flags(Gtk::EventControllerScroll::Flags::BOTH_AXES | Gtk::EventControllerScroll::Flags::KINETIC);
+    m_scroll_controller->signal_scroll_begin().connect(sigc::mem_fun(*this, &ContentViewImpl::stop_kinetic_scrolling));
+    m_scroll_controller->signal_scroll().connect(sigc::mem_fun(*this, &ContentViewImpl::on_scroll), false);
+    m_scroll_controller->signal_decelerate().connect(sigc::mem_fun(*this, &ContentViewImpl::on_decelerate));
+    gtk_widget_add_controller(GTK_WIDGET(m_widget), GTK_EVENT_CONTROLLER (m_scroll_controller->gobj()));
+
+    m_zoom_gesture = Gtk::GestureZoom::create();
+    m_zoom_gesture->signal_begin().connect(sigc::mem_fun(*this, &ContentViewImpl::on_zoom_begin));
+    m_zoom_gesture->signal_scale_changed().connect(sigc::mem_fun(*this, &ContentViewImpl::on_zoom_scale_changed));
+    m_zoom_gesture->signal_end().connect(sigc::mem_fun(*this, &ContentViewImpl::on_zoom_end));
+    m_zoom_gesture->signal_cancel().connect(sigc::mem_fun(*this, &ContentViewImpl::on_zoom_cancel));
+    gtk_widget_add_controller(GTK_WIDGET(m_widget), GTK_EVENT_CONTROLLER (m_zoom_gesture->gobj()));
+
+    on_link_hover = [this](auto const& url) {
+        schedule_hover_prefetch(url);
+    };
+    on_link_unhover = [this] {
+        cancel_hover_prefetch();
+    };
+
     create_client(enable_callgrind_profiling, use_javascript_bytecode);
 }
 
-ContentViewImpl::~ContentViewImpl() = default;
+ContentViewImpl::~ContentViewImpl()
+{
+    cancel_hover_prefetch();
+
+    if (m_motion_tick_callback)
+        gtk_widget_remove_tick_callback(GTK_WIDGET(m_widget), m_motion_tick_callback);
+    stop_kinetic_scrolling();
+    if (m_after_paint_handler)
+        g_signal_handler_disconnect(m_after_paint_clock, m_after_paint_handler);
+    g_clear_object(&m_after_paint_clock);
+
+    g_signal_handlers_disconnect_by_data(m_gtk_settings, this);
+    g_clear_object(&m_gtk_settings);
+    g_clear_object(&m_texture);
+
+    for (auto& it : m_uri_scheme_handlers) {
+        if (it.value.user_data_destroy)
+            it.value.user_data_destroy(it.value.user_data);
+    }
+}
 
 unsigned translate_button(unsigned int button)
 {
@@ -144,134 +227,6 @@ unsigned translate_modifiers(Gdk::ModifierType const state)
     return modifiers;
 }
 
-KeyCode translate_keyval(unsigned int keyval)
-{
-    struct Mapping {
-        constexpr Mapping(int q, KeyCode s)
-                : gdk_key(q)
-                , serenity_key(s)
-        {
-        }
-
-        int gdk_key;
-        KeyCode serenity_key;
-    };
-
-    // TODO: These might be a bit broken
-    constexpr Mapping mappings[] = {
-            { GDK_KEY_0, Key_0 },
-            { GDK_KEY_1, Key_1 },
-            { GDK_KEY_2, Key_2 },
-            { GDK_KEY_3, Key_3 },
-            { GDK_KEY_4, Key_4 },
-            { GDK_KEY_5, Key_5 },
-            { GDK_KEY_6, Key_6 },
-            { GDK_KEY_7, Key_7 },
-            { GDK_KEY_8, Key_8 },
-            { GDK_KEY_9, Key_9 },
-            { GDK_KEY_a, Key_A },
-            { GDK_KEY_Alt_L, Key_Alt },
-            { GDK_KEY_ampersand, Key_Ampersand },
-            { GDK_KEY_apostrophe, Key_Apostrophe },
-            { GDK_KEY_dead_circumflex, Key_Circumflex },
-            { GDK_KEY_asciitilde, Key_Tilde },
-            { GDK_KEY_asterisk, Key_Asterisk },
-            { GDK_KEY_at, Key_AtSign },
-            { GDK_KEY_b, Key_B },
-            { GDK_KEY_backslash, Key_Backslash },
-            { GDK_KEY_BackSpace, Key_Backspace },
-            { GDK_KEY_bar, Key_Pipe },
-            { GDK_KEY_braceleft, Key_LeftBrace },
-            { GDK_KEY_braceright, Key_RightBrace },
-            { GDK_KEY_bracketleft, Key_LeftBracket },
-            { GDK_KEY_bracketright, Key_RightBracket },
-            { GDK_KEY_c, Key_C },
-            { GDK_KEY_Caps_Lock, Key_CapsLock },
-            { GDK_KEY_colon, Key_Colon },
-            { GDK_KEY_comma, Key_Comma },
-            { GDK_KEY_Control_L, Key_Control },
-            { GDK_KEY_d, Key_D },
-            { GDK_KEY_Delete, Key_Delete },
-            { GDK_KEY_dollar, Key_Dollar },
-            { GDK_KEY_Down, Key_Down },
-            { GDK_KEY_e, Key_E },
-            { GDK_KEY_End, Key_End },
-            { GDK_KEY_equal, Key_Equal },
-            { GDK_KEY_Escape, Key_Escape },
-            { GDK_KEY_exclamdown, Key_ExclamationPoint },
-            { GDK_KEY_f, Key_F },
-            { GDK_KEY_F1, Key_F1 },
-            { GDK_KEY_F10, Key_F10 },
-            { GDK_KEY_F11, Key_F11 },
-            { GDK_KEY_F12, Key_F12 },
-            { GDK_KEY_F2, Key_F2 },
-            { GDK_KEY_F3, Key_F3 },
-            { GDK_KEY_F4, Key_F4 },
-            { GDK_KEY_F5, Key_F5 },
-            { GDK_KEY_F6, Key_F6 },
-            { GDK_KEY_F7, Key_F7 },
-            { GDK_KEY_F8, Key_F8 },
-            { GDK_KEY_F9, Key_F9 },
-            { GDK_KEY_g, Key_G },
-            { GDK_KEY_greater, Key_GreaterThan },
-            { GDK_KEY_h, Key_H },
-            { GDK_KEY_Home, Key_Home },
-            { GDK_KEY_i, Key_I },
-            { GDK_KEY_Insert, Key_Insert },
-            { GDK_KEY_j, Key_J },
-            { GDK_KEY_k, Key_K },
-            { GDK_KEY_l, Key_L },
-            { GDK_KEY_Left, Key_Left },
-            { GDK_KEY_less, Key_LessThan },
-            { GDK_KEY_m, Key_M },
-            { GDK_KEY_Menu, Key_Menu },
-            { GDK_KEY_minus, Key_Minus },
-            { GDK_KEY_n, Key_N },
-            { GDK_KEY_Num_Lock, Key_NumLock },
-            { GDK_KEY_o, Key_O },
-            { GDK_KEY_p, Key_P },
-            { GDK_KEY_Page_Down, Key_PageDown },
-            { GDK_KEY_Page_Up, Key_PageUp },
-            { GDK_KEY_parenleft, Key_LeftParen },
-            { GDK_KEY_parenright, Key_RightParen },
-            { GDK_KEY_percent, Key_Percent },
-            { GDK_KEY_period, Key_Period },
-            { GDK_KEY_plus, Key_Plus },
-            { GDK_KEY_Print, Key_PrintScreen },
-            { GDK_KEY_q, Key_Q },
-            { GDK_KEY_question, Key_QuestionMark },
-            { GDK_KEY_quotedbl, Key_DoubleQuote },
-            { GDK_KEY_r, Key_R },
-            { GDK_KEY_Return, Key_Return },
-            { GDK_KEY_Right, Key_Right },
-            { GDK_KEY_s, Key_S },
-            { GDK_KEY_Scroll_Lock, Key_ScrollLock },
-            { GDK_KEY_semicolon, Key_Semicolon },
-            { GDK_KEY_Shift_L, Key_LeftShift },
-            { GDK_KEY_slash, Key_Slash },
-            { GDK_KEY_space, Key_Space },
-            { GDK_KEY_Super_L, Key_Super },
-            { GDK_KEY_Sys_Req, Key_SysRq },
-            { GDK_KEY_t, Key_T },
-            { GDK_KEY_Tab, Key_Tab },
-            { GDK_KEY_u, Key_U },
-            { GDK_KEY_underscore, Key_Underscore },
-            { GDK_KEY_Up, Key_Up },
-            { GDK_KEY_v, Key_V },
-            { GDK_KEY_w, Key_W },
-            { GDK_KEY_x, Key_X },
-            { GDK_KEY_y, Key_Y },
-            { GDK_KEY_z, Key_Z },
-    };
-
-    for (auto const& mapping : mappings) {
-        if ((int) keyval == mapping.gdk_key)
-            return mapping.serenity_key;
-    }
-    dbgln("Keyval {} is invalid", keyval);
-    return Key_Invalid;
-}
-
 bool ContentViewImpl::on_key_pressed(guint keyval, guint, Gdk::ModifierType state)
 {
 //    switch (keyval) {
@@ -293,24 +248,35 @@ bool ContentViewImpl::on_key_pressed(guint keyval, guint, Gdk::ModifierType stat
 //        return;
 //    }
 
+    flush_pending_motion();
+
+    auto timestamp = input_event_timestamp(m_key_controller->get_current_event_time());
     gunichar point = gdk_keyval_to_unicode(keyval);
-    auto key = translate_keyval(keyval);
+    auto key = Ladybird::translate_keyval(keyval);
     auto modifiers = translate_modifiers(state);
     client().async_key_down(key, modifiers, point);
+    did_send_input_event(timestamp);
 
     return true;
 }
 
 void ContentViewImpl::on_key_released(guint keyval, guint, Gdk::ModifierType state)
 {
+    flush_pending_motion();
+
+    auto timestamp = input_event_timestamp(m_key_controller->get_current_event_time());
     gunichar point = gdk_keyval_to_unicode(keyval);
-    auto key = translate_keyval(keyval);
+    auto key = Ladybird::translate_keyval(keyval);
     auto modifiers = translate_modifiers(state);
     client().async_key_up(key, modifiers, point);
+    did_send_input_event(timestamp);
 }
 
 void ContentViewImpl::on_pressed(int n_press, double x, double y)
 {
+    flush_pending_motion();
+    stop_kinetic_scrolling();
+
     Gfx::IntPoint position(x / m_inverse_pixel_scaling_ratio, y / m_inverse_pixel_scaling_ratio);
     auto button = translate_button(m_click_gesture->get_button());
     if (button == 0) {
@@ -320,6 +286,7 @@ void ContentViewImpl::on_pressed(int n_press, double x, double y)
         return;
     }
 
+    auto timestamp = input_event_timestamp(m_click_gesture->get_current_event_time());
     auto state = m_click_gesture->get_current_event_state();
     auto modifiers = translate_modifiers(state);
     auto buttons = translate_buttons(state);
@@ -329,6 +296,7 @@ void ContentViewImpl::on_pressed(int n_press, double x, double y)
     } else {
         client().async_mouse_down(to_content_position(position), button, buttons, modifiers);
     }
+    did_send_input_event(timestamp);
 }
 
 void ContentViewImpl::on_release(int n_press, double x, double y)
@@ -336,6 +304,8 @@ void ContentViewImpl::on_release(int n_press, double x, double y)
     if (n_press > 1)
         return;
 
+    flush_pending_motion();
+
     Gfx::IntPoint position(x / m_inverse_pixel_scaling_ratio, y / m_inverse_pixel_scaling_ratio);
     auto button = translate_button(m_click_gesture->get_button());
 
@@ -353,20 +323,365 @@ void ContentViewImpl::on_release(int n_press, double x, double y)
         // as it will not handle it anyway, and it will (currently) assert
         return;
     }
+    auto timestamp = input_event_timestamp(m_click_gesture->get_current_event_time());
     auto state = m_click_gesture->get_current_event_state();
     auto modifiers = translate_modifiers(state);
     auto buttons = translate_buttons(state);
     client().async_mouse_up(to_content_position(position), button, buttons, modifiers);
+    did_send_input_event(timestamp);
+}
+
+// Same as GtkScrolledWindow: a wheel click scrolls further the more of the page there is to see at once.
+static double wheel_step(GtkAdjustment* adjustment)
+{
+    return pow(gtk_adjustment_get_page_size(adjustment), 2.0 / 3.0);
+}
+
+static constexpr double KINETIC_SCROLL_FRICTION = 4.0;
+static constexpr double KINETIC_SCROLL_MIN_VELOCITY = 10.0;
+
+bool ContentViewImpl::scroll_by(double dx, double dy)
+{
+    bool scrolled = false;
+    auto scroll_adjustment = [&](GtkAdjustment* adjustment, double delta) {
+        if (!adjustment || delta == 0)
+            return;
+        auto old_value = gtk_adjustment_get_value(adjustment);
+        gtk_adjustment_set_value(adjustment, old_value + delta);
+        scrolled |= gtk_adjustment_get_value(adjustment) != old_value;
+    };
+
+    scroll_adjustment(get_horizontal_adj(), dx);
+    scroll_adjustment(get_vertical_adj(), dy);
+    return scrolled;
+}
+
+bool ContentViewImpl::on_scroll(double dx, double dy)
+{
+    auto h_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
+    if (!h_adj && !v_adj)
+        return false;
+
+    stop_kinetic_scrolling();
+
+    if (gtk_event_controller_scroll_get_unit(m_scroll_controller->gobj()) == GDK_SCROLL_UNIT_WHEEL) {
+        dx *= h_adj ? wheel_step(h_adj) : 0;
+        dy *= v_adj ? wheel_step(v_adj) : 0;
+    } else {
+        dx /= m_inverse_pixel_scaling_ratio;
+        dy /= m_inverse_pixel_scaling_ratio;
+    }
+
+    auto timestamp = input_event_timestamp(m_scroll_controller->get_current_event_time());
+    // NOTE: A paint that's already underway is of the viewport from before this scroll, it's the one after that we're waiting on.
+    bool was_painting = m_client_state.back_bitmap.pending_paints > 0;
+    if (scroll_by(dx, dy))
+        did_send_scroll(timestamp, was_painting);
+    return true;
+}
+
+void ContentViewImpl::on_decelerate(double velocity_x, double velocity_y)
+{
+    stop_kinetic_scrolling();
+
+    // NOTE: Wheels are already as fast as they mean to be, only surface (touchpad) scrolling carries on.
+    if (gtk_event_controller_scroll_get_unit(m_scroll_controller->gobj()) == GDK_SCROLL_UNIT_WHEEL)
+        return;
+
+    m_kinetic_velocity_x = velocity_x / m_inverse_pixel_scaling_ratio;
+    m_kinetic_velocity_y = velocity_y / m_inverse_pixel_scaling_ratio;
+    if (hypot(m_kinetic_velocity_x, m_kinetic_velocity_y) < KINETIC_SCROLL_MIN_VELOCITY)
+        return;
+
+    m_kinetic_last_frame_time = 0;
+    m_kinetic_scroll_tick_callback = gtk_widget_add_tick_callback(GTK_WIDGET(m_widget), on_kinetic_scroll_tick, this, nullptr);
+}
+
+gboolean ContentViewImpl::on_kinetic_scroll_tick(GtkWidget*, GdkFrameClock* frame_clock, gpointer user_data)
+{
+    auto* self = static_cast<ContentViewImpl*>(user_data);
+
+    auto frame_time = gdk_frame_clock_get_frame_time(frame_clock);
+    if (self->m_kinetic_last_frame_time == 0) {
+        self->m_kinetic_last_frame_time = frame_time;
+        return G_SOURCE_CONTINUE;
+    }
+
+    auto elapsed = (frame_time - self->m_kinetic_last_frame_time) / 1'000'000.0;
+    self->m_kinetic_last_frame_time = frame_time;
+
+    // NOTE: Velocity decays exponentially, this is how far it takes us over the frame.
+    auto decay = exp(-KINETIC_SCROLL_FRICTION * elapsed);
+    auto travel = (1 - decay) / KINETIC_SCROLL_FRICTION;
+    bool scrolled = self->scroll_by(self->m_kinetic_velocity_x * travel, self->m_kinetic_velocity_y * travel);
+    self->m_kinetic_velocity_x *= decay;
+    self->m_kinetic_velocity_y *= decay;
+
+    if (scrolled && hypot(self->m_kinetic_velocity_x, self->m_kinetic_velocity_y) >= KINETIC_SCROLL_MIN_VELOCITY)
+        return G_SOURCE_CONTINUE;
+
+    self->m_kinetic_scroll_tick_callback = 0;
+    return G_SOURCE_REMOVE;
+}
+
+void ContentViewImpl::stop_kinetic_scrolling()
+{
+    if (!m_kinetic_scroll_tick_callback)
+        return;
+    gtk_widget_remove_tick_callback(GTK_WIDGET(m_widget), m_kinetic_scroll_tick_callback);
+    m_kinetic_scroll_tick_callback = 0;
+}
+
+// NOTE: The same bounds ViewImplementation keeps zoom_in() and zoom_out() within.
+static constexpr float GESTURE_ZOOM_MIN_LEVEL = 0.3f;
+static constexpr float GESTURE_ZOOM_MAX_LEVEL = 5.0f;
+
+void ContentViewImpl::on_zoom_begin(GdkEventSequence*)
+{
+    stop_kinetic_scrolling();
+
+    double x = 0;
+    double y = 0;
+    gtk_gesture_get_bounding_box_center(GTK_GESTURE (m_zoom_gesture->gobj()), &x, &y);
+
+    m_zoom_gesture_state = ZoomGesture {
+        .start_zoom_level = m_zoom_level,
+        .zoom_level = m_zoom_level,
+        .start_viewport_origin = m_viewport_rect.location(),
+        .anchor = Gfx::FloatPoint(x / m_inverse_pixel_scaling_ratio, y / m_inverse_pixel_scaling_ratio),
+    };
+}
+
+void ContentViewImpl::on_zoom_scale_changed(double scale)
+{
+    if (!m_zoom_gesture_state.has_value())
+        return;
+
+    auto& gesture = *m_zoom_gesture_state;
+    gesture.zoom_level = clamp(gesture.start_zoom_level * static_cast<float>(scale), GESTURE_ZOOM_MIN_LEVEL, GESTURE_ZOOM_MAX_LEVEL);
+
+    // NOTE: Nothing goes to WebContent until the gesture is over, we only draw the frame we have at the new scale.
+    gtk_widget_queue_draw(GTK_WIDGET (m_widget));
+}
+
+// Where the viewport ends up once the page is zoomed, keeping the point between the fingers where it is.
+Gfx::FloatPoint ContentViewImpl::zoom_gesture_viewport_origin() const
+{
+    auto const& gesture = *m_zoom_gesture_state;
+    auto scale = gesture.zoom_level / gesture.start_zoom_level;
+    return (gesture.start_viewport_origin.to_type<float>() + gesture.anchor).scaled(scale, scale) - gesture.anchor;
+}
+
+void ContentViewImpl::on_zoom_end(GdkEventSequence*)
+{
+    if (!m_zoom_gesture_state.has_value())
+        return;
+
+    auto gesture = *m_zoom_gesture_state;
+    auto viewport_origin = zoom_gesture_viewport_origin();
+    m_zoom_gesture_state.clear();
+
+    if (gesture.zoom_level == gesture.start_zoom_level) {
+        gtk_widget_queue_draw(GTK_WIDGET (m_widget));
+        return;
+    }
+
+    // NOTE: One zoom change for the whole gesture. The zoom goes first, so the paint we ask for is at the new level.
+    m_zoom_level = gesture.zoom_level;
+    update_content_zoom_level();
+
+    {
+        // Moving the adjustments would otherwise send a viewport and ask for a paint for each of them.
+        TemporaryChange defer_viewport_updates { m_defer_viewport_updates, true };
+
+        // Until WebContent lays the page out again, the adjustments only know how big it was before.
+        auto scale = gesture.zoom_level / gesture.start_zoom_level;
+        auto move_adjustment = [&](GtkAdjustment* adjustment, float value) {
+            if (!adjustment)
+                return;
+            gtk_adjustment_set_upper(adjustment, gtk_adjustment_get_upper(adjustment) * scale);
+            gtk_adjustment_set_value(adjustment, max(0.0f, value));
+        };
+        move_adjustment(get_horizontal_adj(), viewport_origin.x());
+        move_adjustment(get_vertical_adj(), viewport_origin.y());
+    }
+
+    update_viewport_rect();
+}
+
+void ContentViewImpl::on_zoom_cancel(GdkEventSequence*)
+{
+    m_zoom_gesture_state.clear();
+    gtk_widget_queue_draw(GTK_WIDGET (m_widget));
 }
 
 void ContentViewImpl::on_motion(double x, double y)
 {
     Gfx::IntPoint position(x / m_inverse_pixel_scaling_ratio, y / m_inverse_pixel_scaling_ratio);
 
-    auto state = m_click_gesture->get_current_event_state();
+    auto state = m_motion_controller->get_current_event_state();
     auto buttons = translate_buttons(state);
     auto modifiers = translate_modifiers(state);
-    client().async_mouse_move(to_content_position(position), 0, buttons, modifiers);
+
+    ++m_input_statistics.motion_events;
+
+    // NOTE: Coalesced motion is as late as the first event that went into it.
+    auto timestamp = m_pending_motion.has_value() ? m_pending_motion->timestamp : input_event_timestamp(m_motion_controller->get_current_event_time());
+    m_pending_motion = PendingMotion { to_content_position(position), buttons, modifiers, timestamp };
+
+    // NOTE: Drags and modifier changes can't wait for the next frame, or the page would see them out of order.
+    if (buttons != m_last_motion_buttons || modifiers != m_last_motion_modifiers) {
+        ++m_input_statistics.immediate_mouse_moves;
+        flush_pending_motion();
+        return;
+    }
+
+    if (!m_motion_tick_callback)
+        m_motion_tick_callback = gtk_widget_add_tick_callback(GTK_WIDGET(m_widget), on_motion_tick, this, nullptr);
+}
+
+gboolean ContentViewImpl::on_motion_tick(GtkWidget*, GdkFrameClock*, gpointer user_data)
+{
+    auto* self = static_cast<ContentViewImpl*>(user_data);
+    self->m_motion_tick_callback = 0;
+    self->flush_pending_motion();
+    return G_SOURCE_REMOVE;
+}
+
+void ContentViewImpl::flush_pending_motion()
+{
+    if (m_motion_tick_callback) {
+        gtk_widget_remove_tick_callback(GTK_WIDGET(m_widget), m_motion_tick_callback);
+        m_motion_tick_callback = 0;
+    }
+
+    if (!m_pending_motion.has_value())
+        return;
+
+    auto motion = m_pending_motion.release_value();
+    m_last_motion_buttons = motion.buttons;
+    m_last_motion_modifiers = motion.modifiers;
+
+    // NOTE: WebContent hit tests the page for every mouse move it gets.
+    ++m_input_statistics.mouse_moves_sent;
+    client().async_mouse_move(motion.position, 0, motion.buttons, motion.modifiers);
+    did_send_input_event(motion.timestamp);
+}
+
+void ContentViewImpl::did_send_input_event(i64 timestamp)
+{
+    m_inputs_in_flight.enqueue(timestamp);
+}
+
+// NOTE: Scrolling only updates the viewport, which WebContent doesn't acknowledge. So scrolls skip straight to waiting on a paint.
+void ContentViewImpl::did_send_scroll(i64 timestamp, bool behind_current_paint)
+{
+    auto& inputs = behind_current_paint ? m_scrolls_awaiting_next_paint : m_inputs_awaiting_paint;
+    if (inputs.size() >= MAX_INPUTS_AWAITING_PAINT)
+        inputs.remove(0);
+    inputs.append(timestamp);
+}
+
+void ContentViewImpl::did_present_frame()
+{
+    auto now = g_get_monotonic_time();
+    for (auto timestamp : m_inputs_awaiting_presentation)
+        m_input_latency.presented.record(now - timestamp);
+    m_inputs_awaiting_presentation.clear();
+
+    g_signal_handler_disconnect(m_after_paint_clock, m_after_paint_handler);
+    m_after_paint_handler = 0;
+    g_clear_object(&m_after_paint_clock);
+}
+
+void ContentViewImpl::set_hover_prefetch_policy(WebHoverPrefetchPolicy const& policy)
+{
+    m_hover_prefetch_policy = policy;
+    if (!policy.enabled)
+        cancel_hover_prefetch();
+}
+
+void ContentViewImpl::schedule_hover_prefetch(AK::URL const& url)
+{
+    if (!m_hover_prefetch_policy.enabled || !url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv))
+        return;
+    if (m_hovered_link == url)
+        return;
+
+    cancel_hover_prefetch();
+    m_hovered_link = url;
+
+    // NOTE: Passing over a link on the way somewhere else is no reason to go and fetch it.
+    m_hover_prefetch_source = g_timeout_add(
+        m_hover_prefetch_policy.delay_ms,
+        [](gpointer user_data) -> gboolean {
+            auto* self = static_cast<ContentViewImpl*>(user_data);
+            self->m_hover_prefetch_source = 0;
+            self->speculate_on_hovered_link();
+            return G_SOURCE_REMOVE;
+        },
+        this);
+}
+
+void ContentViewImpl::cancel_hover_prefetch()
+{
+    m_hovered_link.clear();
+    if (m_hover_prefetch_source) {
+        g_source_remove(m_hover_prefetch_source);
+        m_hover_prefetch_source = 0;
+    }
+}
+
+void ContentViewImpl::speculate_on_hovered_link()
+{
+    if (!m_hovered_link.has_value() || !m_embed_client)
+        return;
+
+    auto url = m_hovered_link.release_value();
+    auto serialized_url = url.serialize(AK::URL::ExcludeFragment::Yes);
+    if (serialized_url == m_last_speculated_link)
+        return;
+    m_last_speculated_link = move(serialized_url);
+
+    m_embed_client->async_preconnect(url);
+    if (!m_hover_prefetch_policy.prefetch_documents)
+        return;
+
+    HashMap<DeprecatedString, DeprecatedString> request_headers;
+    request_headers.set("Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8");
+
+    // NOTE: A prefetched page is only used by a navigation with the same cookies, so ask for them just like LibWeb is going to.
+    if (on_get_cookie) {
+        auto cookie = on_get_cookie(url, Web::Cookie::Source::Http);
+        if (!cookie.is_empty())
+            request_headers.set("Cookie", move(cookie));
+    }
+
+    m_embed_client->async_prefetch(url, request_headers);
+}
+
+void ContentViewImpl::register_uri_scheme(DeprecatedString const& scheme, UriSchemeHandler handler)
+{
+    if (auto previous = m_uri_scheme_handlers.get(scheme); previous.has_value() && previous->user_data_destroy)
+        previous->user_data_destroy(previous->user_data);
+    m_uri_scheme_handlers.set(scheme, handler);
+
+    if (m_embed_client)
+        m_embed_client->async_register_uri_scheme(scheme);
+}
+
+void ContentViewImpl::handle_uri_scheme_request(i32 request_id, AK::URL const& url)
+{
+    auto handler = m_uri_scheme_handlers.get(url.scheme().to_lowercase());
+    if (!handler.has_value()) {
+        m_embed_client->async_finish_uri_scheme_request(request_id, false, {}, {});
+        return;
+    }
+
+    auto* request = web_uri_scheme_request_new(*m_embed_client, request_id, url.to_deprecated_string().characters());
+    handler->callback(request, handler->user_data);
+    g_object_unref(request);
 }
 
 /*void ContentViewImpl::dragEnterEvent(QDragEnterEvent* event)
@@ -398,6 +713,26 @@ void ContentViewImpl::resize_event(int, int)
     handle_resize();
 }
 
+// NOTE: Paints are asked for by ViewImplementation as well as by us, so there's no one place to note what each one is of.
+//       But the viewport and zoom WebContent paints with only ever change through us, and never while a paint is underway
+//       without coming through here first. So noting them here, before every change and once the paint is back, is the same.
+void ContentViewImpl::note_back_bitmap_paint()
+{
+    if (m_client_state.back_bitmap.pending_paints == 0 || m_noted_paint_bitmap_id == m_client_state.back_bitmap.id)
+        return;
+
+    m_back_bitmap_origin = m_viewport_rect.location();
+    m_back_bitmap_zoom_level = m_content_zoom_level;
+    m_noted_paint_bitmap_id = m_client_state.back_bitmap.id;
+}
+
+void ContentViewImpl::update_content_zoom_level()
+{
+    note_back_bitmap_paint();
+    m_content_zoom_level = m_zoom_level;
+    client().async_set_device_pixels_per_css_pixel(m_device_pixel_ratio * m_zoom_level);
+}
+
 // Runs whenever the widget resizes
 void ContentViewImpl::size_allocate_vfunc(int width, int height, int)
 {
@@ -407,7 +742,7 @@ void ContentViewImpl::size_allocate_vfunc(int width, int height, int)
 void ContentViewImpl::snapshot_vfunc(GtkSnapshot* snapshot)
 {
     int width = gtk_widget_get_allocated_width(GTK_WIDGET (m_widget));
-    int height = gtk_widget_get_allocated_width(GTK_WIDGET (m_widget));
+    int height = gtk_widget_get_allocated_height(GTK_WIDGET (m_widget));
     const Gdk::Rectangle rect(0, 0, width, height);
 
     gtk_snapshot_scale(snapshot, m_inverse_pixel_scaling_ratio, m_inverse_pixel_scaling_ratio);
@@ -429,19 +764,27 @@ void ContentViewImpl::snapshot_vfunc(GtkSnapshot* snapshot)
 
     if (bitmap) {
         graphene_rect_t local_rect;
-        graphene_rect_init(&local_rect, (float)0, (float)0, (float)bitmap_size.width(), (float)bitmap->height());
-        auto cr = gtk_snapshot_append_cairo(snapshot, &local_rect);
 
-        size_t size = bitmap->size_in_bytes();
-        const uint8_t* src = bitmap->scanline_u8(0);
+        // NOTE: The bitmap is drawn where its content is now, at the zoom level it's now at. Whatever it doesn't cover
+        //       after a scroll or a zoom stays blank until WebContent has painted the new viewport.
+        auto zoom_level = m_zoom_gesture_state.has_value() ? m_zoom_gesture_state->zoom_level : m_zoom_level;
+        auto viewport_origin = m_zoom_gesture_state.has_value() ? zoom_gesture_viewport_origin() : m_viewport_rect.location().to_type<float>();
+        auto scale = zoom_level / m_front_bitmap_zoom_level;
+        auto offset = m_front_bitmap_origin.to_type<float>().scaled(scale, scale) - viewport_origin;
+        if (scale != 1.0f || !offset.is_zero()) {
+            graphene_rect_init(&local_rect, 0, 0, width / m_inverse_pixel_scaling_ratio, height / m_inverse_pixel_scaling_ratio);
+            gtk_snapshot_append_color(snapshot, &white, &local_rect);
 
-        // Copy into temporary buffer
-        uint8_t* dest = new uint8_t[size];
-        std::memcpy(dest, src, size);
+            graphene_point_t graphene_offset = GRAPHENE_POINT_INIT(offset.x(), offset.y());
+            gtk_snapshot_translate(snapshot, &graphene_offset);
+            gtk_snapshot_scale(snapshot, scale, scale);
+        }
 
-        auto cairo_bitmap = cairo_image_surface_create_for_data(dest, CAIRO_FORMAT_RGB24, bitmap->width(), bitmap->height(), 4 * bitmap->width());
-        cairo_set_source_surface(cr, cairo_bitmap, 0, 0);
-        cairo_paint(cr);
+        graphene_rect_init(&local_rect, (float)0, (float)0, (float)bitmap_size.width(), (float)bitmap->height());
+        gtk_snapshot_push_clip(snapshot, &local_rect);
+        graphene_rect_init(&local_rect, (float)0, (float)0, (float)bitmap->width(), (float)bitmap->height());
+        gtk_snapshot_append_texture(snapshot, texture_for_bitmap(*bitmap), &local_rect);
+        gtk_snapshot_pop(snapshot);
 
         if (bitmap_size.width() < rect.get_width()) {
             graphene_rect_init(&local_rect, (float)bitmap_size.width(), (float)0, (float)(width - bitmap_size.width()), (float)(bitmap->height()));
@@ -458,8 +801,33 @@ void ContentViewImpl::snapshot_vfunc(GtkSnapshot* snapshot)
 //    gtk_snapshot_append_color(snapshot, &white, rect);
 }
 
+#if GTK_CHECK_VERSION(4, 14, 0)
+static constexpr GdkMemoryFormat BITMAP_MEMORY_FORMAT = GDK_MEMORY_B8G8R8X8;
+#else
+// NOTE: WebContent paints every pixel opaque, so the unused byte is 0xff anyway.
+static constexpr GdkMemoryFormat BITMAP_MEMORY_FORMAT = GDK_MEMORY_B8G8R8A8_PREMULTIPLIED;
+#endif
+
+// NOTE: Snapshots are taken every frame while scrolling or zooming, but the bitmap only changes when WebContent paints.
+//       The texture holds a copy, as WebContent goes on to paint into the same shared memory once it's no longer the front bitmap.
+GdkTexture* ContentViewImpl::texture_for_bitmap(Gfx::Bitmap const& bitmap)
+{
+    if (m_texture && m_texture_bitmap == &bitmap && m_texture_paint_generation == m_paint_generation)
+        return m_texture;
+
+    g_clear_object(&m_texture);
+    auto* bytes = g_bytes_new(bitmap.scanline_u8(0), bitmap.size_in_bytes());
+    m_texture = gdk_memory_texture_new(bitmap.width(), bitmap.height(), BITMAP_MEMORY_FORMAT, bytes, bitmap.pitch());
+    g_bytes_unref(bytes);
+
+    m_texture_bitmap = bitmap;
+    m_texture_paint_generation = m_paint_generation;
+    return m_texture;
+}
+
 void ContentViewImpl::set_viewport_rect(Gfx::IntRect rect)
 {
+    note_back_bitmap_paint();
     m_viewport_rect = rect;
     client().async_set_viewport_rect(rect);
 }
@@ -486,6 +854,9 @@ GtkAdjustment* ContentViewImpl::get_vertical_adj() const
 
 void ContentViewImpl::update_viewport_rect()
 {
+    if (m_defer_viewport_updates)
+        return;
+
     auto scaled_width = int((float)gtk_widget_get_width(GTK_WIDGET (m_widget)) / m_inverse_pixel_scaling_ratio);
     auto scaled_height = int((float)gtk_widget_get_height(GTK_WIDGET (m_widget)) / m_inverse_pixel_scaling_ratio);
 
@@ -498,12 +869,14 @@ void ContentViewImpl::update_viewport_rect()
 
     set_viewport_rect(rect);
 
+    // NOTE: Move the frame we have right away, rather than waiting on WebContent to paint the new viewport.
+    gtk_widget_queue_draw(GTK_WIDGET (m_widget));
     request_repaint();
 }
 
 void ContentViewImpl::update_zoom()
 {
-    client().async_set_device_pixels_per_css_pixel(m_device_pixel_ratio * m_zoom_level);
+    update_content_zoom_level();
     update_viewport_rect();
     request_repaint();
 }
@@ -518,12 +891,22 @@ void ContentViewImpl::hide_event()
     client().async_set_system_visibility_state(false);
 }
 
+static DeprecatedString current_gtk_theme_name(GtkSettings* settings)
+{
+    g_autofree char* theme_name = nullptr;
+    gboolean prefer_dark_theme = FALSE;
+    g_object_get(settings, "gtk-theme-name", &theme_name, "gtk-application-prefer-dark-theme", &prefer_dark_theme, nullptr);
+    return DeprecatedString::formatted("{}{}", theme_name ? theme_name : "", prefer_dark_theme ? ":dark"sv : ""sv);
+}
+
 static Core::AnonymousBuffer make_system_theme_from_gtk_palette(Gtk::Widget& widget, ContentViewImpl::PaletteMode mode)
 {
     auto style_context = widget.get_style_context();
 
     auto theme_file = mode == ContentViewImpl::PaletteMode::Default ? "Default"sv : "Dark"sv;
-    auto theme = Gfx::load_system_theme(DeprecatedString::formatted("{}/res/themes/{}.ini", s_serenity_resource_root, theme_file)).release_value_but_fixme_should_propagate_errors();
+    auto theme_path = DeprecatedString::formatted("res/themes/{}.ini", theme_file);
+    auto theme_config = Core::ConfigFile::open(theme_path, Ladybird::ResourceBundle::open(theme_path).release_value_but_fixme_should_propagate_errors()).release_value_but_fixme_should_propagate_errors();
+    auto theme = Gfx::load_system_theme(theme_config).release_value_but_fixme_should_propagate_errors();
     auto palette_impl = Gfx::PaletteImpl::create_with_anonymous_buffer(theme);
     auto palette = Gfx::Palette(move(palette_impl));
 
@@ -565,18 +948,84 @@ bool is_using_dark_system_theme(Gtk::Widget&)
     return false;
 }
 
+// NOTE: One theme per palette mode, built for whichever GTK theme was current at the time. Every view hands the same
+//       buffer to its WebContent process, so the themes are parsed once and the memory is shared between them all.
+struct CachedSystemTheme {
+    DeprecatedString gtk_theme_name;
+    Core::AnonymousBuffer buffer;
+};
+static Optional<CachedSystemTheme> s_system_themes[2];
+
 void ContentViewImpl::update_palette(PaletteMode mode)
 {
-    auto widget = Glib::wrap(GTK_WIDGET (m_widget));
-    client().async_update_system_theme(make_system_theme_from_gtk_palette(*widget, mode));
+    m_palette_mode = mode;
+
+    auto gtk_theme_name = current_gtk_theme_name(m_gtk_settings);
+    auto& cached_theme = s_system_themes[to_underlying(mode)];
+    if (!cached_theme.has_value() || cached_theme->gtk_theme_name != gtk_theme_name) {
+        auto widget = Glib::wrap(GTK_WIDGET (m_widget));
+        cached_theme = CachedSystemTheme { move(gtk_theme_name), make_system_theme_from_gtk_palette(*widget, mode) };
+    }
+
+    client().async_update_system_theme(cached_theme->buffer);
+}
+
+void ContentViewImpl::gtk_theme_changed()
+{
+    // NOTE: The first view to hear about it rebuilds the theme, the others pick up the new one from the cache.
+    update_palette(m_palette_mode);
+    request_repaint();
+}
+
+// NOTE: We hold a connection to the NetworkServer ourselves, so it stays around for as long as we do, not just as long as some WebContent process does.
+static RefPtr<Ladybird::NetworkServerClient> s_network_server;
+
+static void ensure_network_server_is_running()
+{
+    if (s_network_server && s_network_server->is_open())
+        return;
+
+    auto result = [&]() -> ErrorOr<void> {
+        auto candidate_network_server_paths = TRY(get_paths_for_helper_process("NetworkServer"sv));
+        auto socket_path = TRY(Ladybird::NetworkServerClient::launch_server(candidate_network_server_paths));
+        s_network_server = TRY(Ladybird::NetworkServerClient::connect(socket_path));
+        g_setenv(NETWORK_SERVER_SOCKET_ENV, socket_path.characters(), TRUE);
+        return {};
+    }();
+
+    if (result.is_error()) {
+        dbgln("Failed to launch NetworkServer, WebContent will load in-process: {}", result.error());
+        s_network_server = nullptr;
+        g_unsetenv(NETWORK_SERVER_SOCKET_ENV);
+    }
 }
 
 void ContentViewImpl::create_client(WebView::EnableCallgrindProfiling enable_callgrind_profiling, WebView::UseJavaScriptBytecode use_javascript_bytecode)
 {
     m_client_state = {};
 
+    // NOTE: A new content process won't be answering for the inputs its predecessor never got to.
+    m_inputs_in_flight.clear();
+    m_inputs_awaiting_paint.clear();
+    m_scrolls_awaiting_next_paint.clear();
+
+    if (Ladybird::NetworkSettings::from_environment().use_network_server)
+        ensure_network_server_is_running();
+
     auto candidate_web_content_paths = get_paths_for_helper_process("WebContent"sv).release_value_but_fixme_should_propagate_errors();
+    auto embed_socket = Ladybird::EmbedClient::start_handing_over_socket().release_value_but_fixme_should_propagate_errors();
     auto new_client = launch_web_content_process(candidate_web_content_paths, enable_callgrind_profiling, WebView::IsLayoutTestMode::No, use_javascript_bytecode).release_value_but_fixme_should_propagate_errors();
+    Ladybird::EmbedClient::finish_handing_over_socket();
+
+    m_embed_client = Ladybird::EmbedClient::try_create(move(embed_socket)).release_value_but_fixme_should_propagate_errors();
+    m_embed_client->on_upload_progress = [this](AK::URL const& url, u64 bytes_sent, u64 total_bytes) {
+        g_signal_emit_by_name(m_widget, "upload-progress", url.to_deprecated_string().characters(), (guint64)bytes_sent, (guint64)total_bytes);
+    };
+    m_embed_client->on_uri_scheme_request = [this](i32 request_id, AK::URL const& url) {
+        handle_uri_scheme_request(request_id, url);
+    };
+    for (auto const& it : m_uri_scheme_handlers)
+        m_embed_client->async_register_uri_scheme(it.key);
 
     m_client_state.client = new_client;
     m_client_state.client->on_web_content_process_crash = [this] {
@@ -590,6 +1039,8 @@ void ContentViewImpl::create_client(WebView::EnableCallgrindProfiling enable_cal
     client().async_set_window_handle(m_client_state.client_handle);
 
     client().async_set_device_pixels_per_css_pixel(m_device_pixel_ratio);
+    m_content_zoom_level = 1.0f;
+    m_noted_paint_bitmap_id = -1;
     update_palette();
     client().async_update_system_fonts(Gfx::FontDatabase::default_font_query(), Gfx::FontDatabase::fixed_width_font_query(), Gfx::FontDatabase::window_title_font_query());
 
@@ -620,14 +1071,40 @@ void ContentViewImpl::create_client(WebView::EnableCallgrindProfiling enable_cal
 void ContentViewImpl::notify_server_did_paint(Badge<WebContentClient>, i32 bitmap_id, Gfx::IntSize size)
 {
     if (m_client_state.back_bitmap.id == bitmap_id) {
+        note_back_bitmap_paint();
+        m_noted_paint_bitmap_id = -1;
         m_client_state.has_usable_bitmap = true;
         m_client_state.back_bitmap.pending_paints--;
         m_client_state.back_bitmap.last_painted_size = size;
         swap(m_client_state.back_bitmap, m_client_state.front_bitmap);
+        ++m_paint_generation;
+        m_front_bitmap_origin = m_back_bitmap_origin;
+        m_front_bitmap_zoom_level = m_back_bitmap_zoom_level;
         // We don't need the backup bitmap anymore, so drop it.
         m_backup_bitmap = nullptr;
         gtk_widget_queue_draw(GTK_WIDGET (m_widget));
 
+        auto now = g_get_monotonic_time();
+        for (auto timestamp : m_inputs_awaiting_paint) {
+            if (now - timestamp > MAX_INPUT_TO_PAINT_LATENCY)
+                continue;
+            m_input_latency.painted.record(now - timestamp);
+            m_inputs_awaiting_presentation.append(timestamp);
+        }
+        m_inputs_awaiting_paint.clear();
+        // NOTE: The repaint asked for while this one was underway is the one going out below.
+        swap(m_inputs_awaiting_paint, m_scrolls_awaiting_next_paint);
+
+        // NOTE: The frame we just queued is done once the frame clock is through painting.
+        if (!m_inputs_awaiting_presentation.is_empty() && !m_after_paint_handler) {
+            if (auto* frame_clock = gtk_widget_get_frame_clock(GTK_WIDGET (m_widget))) {
+                m_after_paint_clock = GDK_FRAME_CLOCK (g_object_ref (frame_clock));
+                m_after_paint_handler = g_signal_connect_swapped (frame_clock, "after-paint", G_CALLBACK (signal_after_paint), this);
+            } else {
+                m_inputs_awaiting_presentation.clear();
+            }
+        }
+
         if (m_client_state.got_repaint_requests_while_painting) {
             m_client_state.got_repaint_requests_while_painting = false;
             request_repaint();
@@ -729,7 +1206,7 @@ void ContentViewImpl::notify_server_did_layout(Badge<WebContentClient>, Gfx::Int
 void ContentViewImpl::notify_server_did_request_scroll(Badge<WebContentClient>, i32 x_delta, i32 y_delta)
 {
     auto h_adj = get_horizontal_adj();
-    auto v_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
 
     if (h_adj) {
         int h_adj_value = (int) gtk_adjustment_get_value(h_adj);
@@ -745,7 +1222,7 @@ void ContentViewImpl::notify_server_did_request_scroll(Badge<WebContentClient>,
 void ContentViewImpl::notify_server_did_request_scroll_to(Badge<WebContentClient>, Gfx::IntPoint scroll_position)
 {
     auto h_adj = get_horizontal_adj();
-    auto v_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
 
     if (h_adj) {
         gtk_adjustment_set_value(h_adj, scroll_position.x());
@@ -761,7 +1238,7 @@ void ContentViewImpl::notify_server_did_request_scroll_into_view(Badge<WebConten
     if (m_viewport_rect.contains(rect))
         return;
 
-    auto v_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
 
     if (v_adj && rect.top() < m_viewport_rect.top())
         gtk_adjustment_set_value(v_adj, rect.top());
@@ -851,11 +1328,30 @@ void ContentViewImpl::notify_server_did_request_dismiss_dialog(Badge<WebContentC
 
 void ContentViewImpl::notify_server_did_request_file(Badge<WebContentClient>, DeprecatedString const& path, i32 request_id)
 {
+    // NOTE: Our own pages (like the error page) are requested by their path in the resource root, but may well come from the bundle.
+    auto relative_path = Ladybird::ResourceBundle::relative_path(path);
+    if (relative_path.has_value() && Ladybird::ResourceBundle::lookup(*relative_path).has_value()) {
+        auto resource = Ladybird::ResourceBundle::open(*relative_path);
+        if (resource.is_error())
+            client().async_handle_file_return(resource.error().code(), {}, request_id);
+        else
+            client().async_handle_file_return(0, IPC::File(*resource.value()), request_id);
+        return;
+    }
+
     auto file = Core::File::open(path, Core::File::OpenMode::Read);
-    if (file.is_error())
+    if (file.is_error()) {
         client().async_handle_file_return(file.error().code(), {}, request_id);
-    else
-        client().async_handle_file_return(0, IPC::File(*file.value()), request_id);
+        return;
+    }
+
+    // NOTE: WebContent reads the whole file as soon as it gets the descriptor. Advice sticks to the open file rather than
+    //       the descriptor, so it carries over, and the kernel can start reading the file in while the IPC message is on its way.
+    auto fd = file.value()->fd();
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+
+    client().async_handle_file_return(0, IPC::File(*file.value()), request_id);
 }
 
 Gfx::IntRect ContentViewImpl::viewport_rect() const
@@ -867,7 +1363,7 @@ Gfx::IntPoint ContentViewImpl::to_content_position(Gfx::IntPoint widget_position
 {
     auto h_adj = get_horizontal_adj();
     int h_adj_value = h_adj != nullptr ? (int) gtk_adjustment_get_value(h_adj) : 0;
-    auto v_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
     int v_adj_value = v_adj != nullptr ? (int) gtk_adjustment_get_value(v_adj) : 0;
 
     return widget_position.translated(max(0, h_adj_value), max(0, v_adj_value));
@@ -877,7 +1373,7 @@ Gfx::IntPoint ContentViewImpl::to_widget_position(Gfx::IntPoint content_position
 {
     auto h_adj = get_horizontal_adj();
     int h_adj_value = h_adj != nullptr ? (int) gtk_adjustment_get_value(h_adj) : 0;
-    auto v_adj = get_horizontal_adj();
+    auto v_adj = get_vertical_adj();
     int v_adj_value = v_adj != nullptr ? (int) gtk_adjustment_get_value(v_adj) : 0;
 
     return content_position.translated(-(max(0, h_adj_value)), -(max(0, v_adj_value)));
@@ -911,6 +1407,16 @@ void ContentViewImpl::notify_server_did_finish_handling_input_event(bool event_w
     // FIXME: Currently browser handles the keyboard shortcuts before passing the event to web content, so
     //        we don't need to do anything here. But we'll need to once we start asking web content first.
     (void)event_was_accepted;
+
+    if (m_inputs_in_flight.is_empty())
+        return;
+
+    auto timestamp = m_inputs_in_flight.dequeue();
+    m_input_latency.handled.record(g_get_monotonic_time() - timestamp);
+
+    if (m_inputs_awaiting_paint.size() >= MAX_INPUTS_AWAITING_PAINT)
+        m_inputs_awaiting_paint.remove(0);
+    m_inputs_awaiting_paint.append(timestamp);
 }
 
 ErrorOr<String> ContentViewImpl::dump_layout_tree()
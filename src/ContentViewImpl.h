@@ -12,6 +12,7 @@
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
+#include <AK/Queue.h>
 #include <AK/URL.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/Rect.h>
@@ -30,11 +31,15 @@
 #include <gtkmm/eventcontrollerfocus.h>
 #include <gtkmm/gesturedrag.h>
 #include <gtkmm/gestureclick.h>
+#include <gtkmm/gesturezoom.h>
 #include <gtkmm/eventcontrollermotion.h>
+#include <gtkmm/eventcontrollerscroll.h>
 #include <gtkmm/scrollable.h>
 #include <gtkmm/snapshot.h>
 #include <gtkmm/alertdialog.h>
 #include "Embed/webcontentview.h"
+#include "EmbedClient.h"
+#include "InputLatency.h"
 
 namespace WebView {
     class WebContentClient;
@@ -86,6 +91,7 @@ public:
         Dark,
     };
     void update_palette(PaletteMode = PaletteMode::Default);
+    void gtk_theme_changed();
 
     virtual void notify_server_did_layout(Badge<WebContentClient>, Gfx::IntSize content_size) override;
     virtual void notify_server_did_paint(Badge<WebContentClient>, i32 bitmap_id, Gfx::IntSize) override;
@@ -108,6 +114,22 @@ public:
 
     void update_viewport_rect();
 
+    Ladybird::EmbedClient* embed_client() { return m_embed_client.ptr(); }
+
+    void set_hover_prefetch_policy(WebHoverPrefetchPolicy const&);
+
+    WebInputStatistics const& input_statistics() const { return m_input_statistics; }
+    Ladybird::InputLatency const& input_latency() const { return m_input_latency; }
+    void reset_input_latency() { m_input_latency.reset(); }
+    void did_present_frame();
+
+    struct UriSchemeHandler {
+        WebUriSchemeRequestCallback callback { nullptr };
+        gpointer user_data { nullptr };
+        GDestroyNotify user_data_destroy { nullptr };
+    };
+    void register_uri_scheme(DeprecatedString const& scheme, UriSchemeHandler);
+
 private:
     // ^WebView::ViewImplementation
     virtual void create_client(WebView::EnableCallgrindProfiling = WebView::EnableCallgrindProfiling::No, WebView::UseJavaScriptBytecode = WebView::UseJavaScriptBytecode::No) override;
@@ -119,25 +141,119 @@ private:
     // bool on_key_pressed(guint keyval, guint keycode, Gdk::ModifierType state);
     // void on_key_released(guint keyval, guint keycode, Gdk::ModifierType state);
     void on_motion(double x, double y);
+    void flush_pending_motion();
+    void did_send_input_event(i64 timestamp);
+    void did_send_scroll(i64 timestamp, bool behind_current_paint);
+    static gboolean on_motion_tick(GtkWidget*, GdkFrameClock*, gpointer);
+
+    void schedule_hover_prefetch(AK::URL const&);
+    void cancel_hover_prefetch();
+    void speculate_on_hovered_link();
+    void handle_uri_scheme_request(i32 request_id, AK::URL const&);
 
     Glib::RefPtr<Gtk::EventControllerKey> m_key_controller;
     Glib::RefPtr<Gtk::EventControllerFocus> m_focus_controller;
     Glib::RefPtr<Gtk::EventControllerMotion> m_motion_controller;
     Glib::RefPtr<Gtk::GestureClick> m_click_gesture;
+    Glib::RefPtr<Gtk::EventControllerScroll> m_scroll_controller;
+    Glib::RefPtr<Gtk::GestureZoom> m_zoom_gesture;
 
     bool on_key_pressed(guint keyval, guint keycode, Gdk::ModifierType state);
     void on_key_released(guint keyval, guint keycode, Gdk::ModifierType state);
     void on_pressed(int n_press, double x, double y);
     void on_release(int n_press, double x, double y);
+    bool on_scroll(double dx, double dy);
+    void on_decelerate(double velocity_x, double velocity_y);
+
+    bool scroll_by(double dx, double dy);
+    void stop_kinetic_scrolling();
+    static gboolean on_kinetic_scroll_tick(GtkWidget*, GdkFrameClock*, gpointer);
+
+    void on_zoom_begin(GdkEventSequence*);
+    void on_zoom_scale_changed(double scale);
+    void on_zoom_end(GdkEventSequence*);
+    void on_zoom_cancel(GdkEventSequence*);
+    Gfx::FloatPoint zoom_gesture_viewport_origin() const;
+
+    void note_back_bitmap_paint();
+    void update_content_zoom_level();
+    GdkTexture* texture_for_bitmap(Gfx::Bitmap const&);
 
     GtkAdjustment * get_horizontal_adj() const;
     GtkAdjustment * get_vertical_adj() const;
 
     float m_inverse_pixel_scaling_ratio { 1.0 };
+
+    // NOTE: Where the viewport was when each bitmap was asked for. Until WebContent catches up after a scroll,
+    //       the front bitmap is drawn offset by how far the viewport has moved since.
+    Gfx::IntPoint m_back_bitmap_origin;
+    Gfx::IntPoint m_front_bitmap_origin;
+    // NOTE: Likewise for zoom, so a pinch only scales the frame we have and WebContent re-renders once it's over.
+    float m_back_bitmap_zoom_level { 1.0f };
+    float m_front_bitmap_zoom_level { 1.0f };
+    // The zoom level WebContent was last told to paint at, which ViewImplementation::zoom_in() and friends change m_zoom_level ahead of.
+    float m_content_zoom_level { 1.0f };
+    // The back bitmap whose pending paint has had its origin and zoom level noted, if any.
+    i32 m_noted_paint_bitmap_id { -1 };
+
+    // The last bitmap drawn, as of the paint it was drawn after. The texture is rebuilt whenever either has changed since.
+    GdkTexture* m_texture { nullptr };
+    RefPtr<Gfx::Bitmap const> m_texture_bitmap;
+    u64 m_texture_paint_generation { 0 };
+    u64 m_paint_generation { 0 };
+
+    struct ZoomGesture {
+        float start_zoom_level { 1.0f };
+        float zoom_level { 1.0f };
+        Gfx::IntPoint start_viewport_origin;
+        // Between the fingers, in device pixels from the top left of the widget.
+        Gfx::FloatPoint anchor;
+    };
+    Optional<ZoomGesture> m_zoom_gesture_state;
+    bool m_defer_viewport_updates { false };
+
+    guint m_kinetic_scroll_tick_callback { 0 };
+    double m_kinetic_velocity_x { 0 };
+    double m_kinetic_velocity_y { 0 };
+    gint64 m_kinetic_last_frame_time { 0 };
+    PaletteMode m_palette_mode { PaletteMode::Default };
+    GtkSettings *m_gtk_settings { nullptr };
     bool m_should_show_line_box_borders { false };
 
     Glib::RefPtr<Gtk::AlertDialog> m_dialog;
 
+    RefPtr<Ladybird::EmbedClient> m_embed_client;
+
+    // NOTE: Motion is sent at most once per frame, only the latest position counts.
+    struct PendingMotion {
+        Gfx::IntPoint position;
+        unsigned buttons { 0 };
+        unsigned modifiers { 0 };
+        i64 timestamp { 0 };
+    };
+    Optional<PendingMotion> m_pending_motion;
+    unsigned m_last_motion_buttons { 0 };
+    unsigned m_last_motion_modifiers { 0 };
+    guint m_motion_tick_callback { 0 };
+    WebInputStatistics m_input_statistics {};
+
+    // NOTE: WebContent handles input events in order, and tells us when it's done with each one.
+    Queue<i64> m_inputs_in_flight;
+    Vector<i64> m_inputs_awaiting_paint;
+    Vector<i64> m_scrolls_awaiting_next_paint;
+    Vector<i64> m_inputs_awaiting_presentation;
+    GdkFrameClock *m_after_paint_clock { nullptr };
+    gulong m_after_paint_handler { 0 };
+    Ladybird::InputLatency m_input_latency;
+
+    WebHoverPrefetchPolicy m_hover_prefetch_policy {};
+    Optional<AK::URL> m_hovered_link;
+    guint m_hover_prefetch_source { 0 };
+    DeprecatedString m_last_speculated_link;
+
+    // NOTE: Kept here rather than in the content process, so they're registered again with a new one after a crash.
+    HashMap<DeprecatedString, UriSchemeHandler> m_uri_scheme_handlers;
+
     Gfx::IntRect m_viewport_rect;
 
     StringView m_webdriver_content_ipc_path;
@@ -6,8 +6,10 @@
 
 #include "webcontentview.h"
 #include "ContentViewImpl.h"
+#include "RequestTiming.h"
 #include "Utilities.h"
 
+#include <cstring>
 #include <memory>
 #include <optional>
 
@@ -169,6 +171,233 @@ web_content_view_load (WebContentView *self, const char *url)
     }
 }
 
+gboolean
+web_content_view_get_http_cache_statistics (WebContentView *self, WebHttpCacheStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != nullptr, FALSE);
+
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return FALSE;
+
+    auto response = self->view_impl->embed_client()->get_http_cache_statistics();
+    if (!response.enabled())
+        return FALSE;
+
+    statistics->memory_hits = response.memory_hits();
+    statistics->disk_hits = response.disk_hits();
+    statistics->revalidations = response.revalidations();
+    statistics->misses = response.misses();
+    statistics->stores = response.stores();
+    statistics->evictions = response.evictions();
+    statistics->memory_size = response.memory_size();
+    statistics->disk_size = response.disk_size();
+    return TRUE;
+}
+
+WebRequestTiming *
+web_content_view_get_request_timings (WebContentView *self, guint *n_timings)
+{
+    g_return_val_if_fail (n_timings != nullptr, nullptr);
+
+    *n_timings = 0;
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return nullptr;
+
+    auto timings = self->view_impl->embed_client()->get_request_timings().take_timings();
+    if (timings.is_empty())
+        return nullptr;
+
+    auto *result = g_new0 (WebRequestTiming, timings.size());
+    for (size_t i = 0; i < timings.size(); ++i) {
+        auto const& timing = timings[i];
+        result[i].method = g_strdup (timing.method.characters());
+        result[i].url = g_strdup (timing.url.characters());
+        result[i].status_code = timing.status_code;
+        result[i].from_cache = timing.from_cache;
+        result[i].start_time = timing.start_time;
+        result[i].blocked = timing.blocked;
+        result[i].dns = timing.dns;
+        result[i].connect = timing.connect;
+        result[i].tls = timing.tls;
+        result[i].send = timing.send;
+        result[i].wait = timing.wait;
+        result[i].receive = timing.receive;
+        result[i].total = timing.total();
+        result[i].request_header_size = timing.request_header_size;
+        result[i].request_body_size = timing.request_body_size;
+        result[i].response_header_size = timing.response_header_size;
+        result[i].response_body_size = timing.response_body_size;
+        result[i].decoded_body_size = timing.decoded_body_size;
+    }
+
+    *n_timings = timings.size();
+    return result;
+}
+
+void
+web_request_timings_free (WebRequestTiming *timings, guint n_timings)
+{
+    for (guint i = 0; i < n_timings; ++i) {
+        g_free (timings[i].method);
+        g_free (timings[i].url);
+    }
+    g_free (timings);
+}
+
+void
+web_content_view_clear_request_timings (WebContentView *self)
+{
+    if (self->view_impl.has_value() && self->view_impl->embed_client())
+        self->view_impl->embed_client()->async_clear_request_timings();
+}
+
+guint64
+web_content_view_get_coalesced_request_count (WebContentView *self)
+{
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return 0;
+
+    return self->view_impl->embed_client()->get_coalesced_request_count().count();
+}
+
+void
+web_content_view_get_preload_statistics (WebContentView *self, WebPreloadStatistics *statistics)
+{
+    g_return_if_fail (statistics != nullptr);
+
+    *statistics = {};
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return;
+
+    auto response = self->view_impl->embed_client()->get_preload_statistics();
+    statistics->issued = response.issued();
+    statistics->used = response.used();
+    statistics->wasted = response.wasted();
+}
+
+void
+web_content_view_get_input_statistics (WebContentView *self, WebInputStatistics *statistics)
+{
+    g_return_if_fail (statistics != nullptr);
+
+    *statistics = {};
+    if (!self->view_impl.has_value())
+        return;
+
+    *statistics = self->view_impl->input_statistics();
+}
+
+void
+web_content_view_get_input_latency (WebContentView *self, WebInputLatencyStage stage, WebInputLatency *latency)
+{
+    g_return_if_fail (latency != nullptr);
+
+    *latency = { 0, -1, -1, -1, -1, -1 };
+    if (!self->view_impl.has_value())
+        return;
+
+    auto const& input_latency = self->view_impl->input_latency();
+    auto const& histogram = stage == WEB_INPUT_LATENCY_HANDLED ? input_latency.handled
+                          : stage == WEB_INPUT_LATENCY_PAINTED ? input_latency.painted
+                          : input_latency.presented;
+    if (histogram.count() == 0)
+        return;
+
+    latency->count = histogram.count();
+    latency->p50 = histogram.percentile (50);
+    latency->p90 = histogram.percentile (90);
+    latency->p95 = histogram.percentile (95);
+    latency->p99 = histogram.percentile (99);
+    latency->max = histogram.max();
+}
+
+void
+web_content_view_reset_input_latency (WebContentView *self)
+{
+    if (self->view_impl.has_value())
+        self->view_impl->reset_input_latency();
+}
+
+void
+web_content_view_get_tls_statistics (WebContentView *self, WebTlsStatistics *statistics)
+{
+    g_return_if_fail (statistics != nullptr);
+
+    *statistics = {};
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return;
+
+    auto response = self->view_impl->embed_client()->get_tls_statistics();
+    statistics->handshakes = response.handshakes();
+    statistics->resumption_attempts = response.resumption_attempts();
+    statistics->resumed = response.resumed();
+    statistics->handshake_time = response.handshake_time();
+}
+
+void
+web_content_view_set_hover_prefetch_policy (WebContentView *self, const WebHoverPrefetchPolicy *policy)
+{
+    if (!self->view_impl.has_value())
+        return;
+
+    WebHoverPrefetchPolicy none {};
+    self->view_impl->set_hover_prefetch_policy(policy ? *policy : none);
+}
+
+void
+web_content_view_set_network_conditions (WebContentView *self, const WebNetworkConditions *conditions)
+{
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client())
+        return;
+
+    WebNetworkConditions none {};
+    if (!conditions)
+        conditions = &none;
+
+    self->view_impl->embed_client()->async_set_network_conditions(conditions->latency_ms, conditions->download_throughput, conditions->upload_throughput, CLAMP (conditions->failure_rate, 0.0, 1.0));
+}
+
+void
+web_content_view_register_uri_scheme (WebContentView *self,
+                                      const char *scheme,
+                                      WebUriSchemeRequestCallback callback,
+                                      gpointer user_data,
+                                      GDestroyNotify user_data_destroy)
+{
+    g_return_if_fail (scheme != nullptr && *scheme);
+    g_return_if_fail (callback != nullptr);
+    g_return_if_fail (!StringView { scheme, strlen (scheme) }.is_one_of_ignoring_ascii_case ("http"sv, "https"sv, "file"sv, "data"sv, "about"sv, "blob"sv));
+
+    if (!self->view_impl.has_value()) {
+        if (user_data_destroy)
+            user_data_destroy (user_data);
+        return;
+    }
+
+    self->view_impl->register_uri_scheme (DeprecatedString { scheme }.to_lowercase(), { callback, user_data, user_data_destroy });
+}
+
+gboolean
+web_content_view_export_har (WebContentView *self, const char *path, GError **error)
+{
+    g_return_val_if_fail (path != nullptr, FALSE);
+
+    if (!self->view_impl.has_value() || !self->view_impl->embed_client()) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED, "The view has no content process yet");
+        return FALSE;
+    }
+
+    auto timings = self->view_impl->embed_client()->get_request_timings().take_timings();
+    auto har_or_error = Ladybird::serialize_as_har(timings);
+    if (har_or_error.is_error()) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Unable to serialize request timings");
+        return FALSE;
+    }
+
+    auto har = har_or_error.release_value();
+    return g_file_set_contents (path, har.characters(), har.length(), error);
+}
+
 static void
 web_content_view_snapshot(GtkWidget *self, GtkSnapshot *snapshot)
 {
@@ -204,6 +433,14 @@ web_content_view_class_init (WebContentViewClass *klass)
 
     widget_class->snapshot = web_content_view_snapshot;
     widget_class->size_allocate = web_content_view_size_allocate;
+
+    // Emitted every so often while a request body is being uploaded.
+    g_signal_new ("upload-progress",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL,
+                  G_TYPE_NONE, 3,
+                  G_TYPE_STRING, G_TYPE_UINT64, G_TYPE_UINT64);
 }
 
 static void
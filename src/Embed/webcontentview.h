@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "webembed.h"
+#include "weburischemerequest.h"
 #include <gtk/gtk.h>
 
 G_BEGIN_DECLS
@@ -14,10 +16,148 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (WebContentView, web_content_view, WEB, CONTENT_VIEW, GtkWidget)
 
+typedef struct {
+    guint64 memory_hits;
+    guint64 disk_hits;
+    guint64 revalidations;
+    guint64 misses;
+    guint64 stores;
+    guint64 evictions;
+    guint64 memory_size;
+    guint64 disk_size;
+} WebHttpCacheStatistics;
+
+/* Durations are in microseconds, or -1 where that phase didn't happen. */
+typedef struct {
+    char *method;
+    char *url;
+    guint status_code;
+    gboolean from_cache;
+    gint64 start_time;
+    gint64 blocked;
+    gint64 dns;
+    gint64 connect;
+    gint64 tls;
+    gint64 send;
+    gint64 wait;
+    gint64 receive;
+    gint64 total;
+    guint64 request_header_size;
+    guint64 request_body_size;
+    guint64 response_header_size;
+    guint64 response_body_size;
+    guint64 decoded_body_size;
+} WebRequestTiming;
+
+/* handshake_time is in microseconds, summed over every handshake.
+ * resumed stays 0 where the TLS backend can't tell whether a session was resumed. */
+typedef struct {
+    guint64 handshakes;
+    guint64 resumption_attempts;
+    guint64 resumed;
+    guint64 handshake_time;
+} WebTlsStatistics;
+
+/* Hovering a link for delay_ms opens a connection to its server, and with prefetch_documents also fetches the page itself. */
+typedef struct {
+    gboolean enabled;
+    guint delay_ms;
+    gboolean prefetch_documents;
+} WebHoverPrefetchPolicy;
+
+/* Called on the main thread for every request the view's page makes for a registered scheme. */
+typedef void (*WebUriSchemeRequestCallback) (WebUriSchemeRequest *request, gpointer user_data);
+
+typedef struct {
+    guint64 issued;
+    guint64 used;
+    guint64 wasted;
+} WebPreloadStatistics;
+
+/* Motion is sent to the page at most once per frame. Every mouse move sent is one hit test in the content process,
+ * immediate_mouse_moves are those sent straight away because the buttons or modifiers changed. */
+typedef struct {
+    guint64 motion_events;
+    guint64 mouse_moves_sent;
+    guint64 immediate_mouse_moves;
+} WebInputStatistics;
+
+typedef enum {
+    WEB_INPUT_LATENCY_HANDLED,
+    WEB_INPUT_LATENCY_PAINTED,
+    WEB_INPUT_LATENCY_PRESENTED,
+} WebInputLatencyStage;
+
+/* Microseconds from the input event to the stage, or -1 without any samples.
+ * Scrolls only count towards WEB_INPUT_LATENCY_PAINTED and WEB_INPUT_LATENCY_PRESENTED.
+ * Percentiles are accurate to within 12.5%. */
+typedef struct {
+    guint64 count;
+    gint64 p50;
+    gint64 p90;
+    gint64 p95;
+    gint64 p99;
+    gint64 max;
+} WebInputLatency;
+
 GtkWidget *
 web_content_view_new ();
 
 void
 web_content_view_load (WebContentView *self, const char *url);
 
+gboolean
+web_content_view_get_http_cache_statistics (WebContentView *self, WebHttpCacheStatistics *statistics);
+
+WebRequestTiming *
+web_content_view_get_request_timings (WebContentView *self, guint *n_timings);
+
+void
+web_request_timings_free (WebRequestTiming *timings, guint n_timings);
+
+void
+web_content_view_clear_request_timings (WebContentView *self);
+
+/* How many of the view's requests were answered by an identical one that was already in flight. */
+guint64
+web_content_view_get_coalesced_request_count (WebContentView *self);
+
+/* Subresources fetched ahead of the parser, and how many of those the page went on to use. */
+void
+web_content_view_get_preload_statistics (WebContentView *self, WebPreloadStatistics *statistics);
+
+/* TLS sessions are resumed per origin for as long as the content process lives, or the shared network process if there is one. */
+void
+web_content_view_get_tls_statistics (WebContentView *self, WebTlsStatistics *statistics);
+
+void
+web_content_view_get_input_statistics (WebContentView *self, WebInputStatistics *statistics);
+
+/* How long key presses, clicks and motion took to be handled by the page, to be painted, and for that paint to be drawn. */
+void
+web_content_view_get_input_latency (WebContentView *self, WebInputLatencyStage stage, WebInputLatency *latency);
+
+void
+web_content_view_reset_input_latency (WebContentView *self);
+
+/* Off unless set, pass NULL to turn it off again. */
+void
+web_content_view_set_hover_prefetch_policy (WebContentView *self, const WebHoverPrefetchPolicy *policy);
+
+/* Answers requests for scheme: URLs with callback instead of the network. Registering a scheme again replaces its callback.
+ * The standard schemes (http, https, file, data, about, blob) can't be taken over. */
+void
+web_content_view_register_uri_scheme (WebContentView *self,
+                                      const char *scheme,
+                                      WebUriSchemeRequestCallback callback,
+                                      gpointer user_data,
+                                      GDestroyNotify user_data_destroy);
+
+gboolean
+web_content_view_export_har (WebContentView *self, const char *path, GError **error);
+
+/* Applies to the view's content process from now on, or to the whole application when it uses a shared network process. */
+void
+web_content_view_set_network_conditions (WebContentView *self, const WebNetworkConditions *conditions);
+
 G_END_DECLS
@@ -0,0 +1,578 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "webdownload.h"
+#include <AK/Types.h>
+#include <libsoup/soup.h>
+
+static constexpr gsize READ_CHUNK_SIZE = 64 * KiB;
+// Below this, a range isn't worth a connection of its own.
+static constexpr guint64 MIN_RANGE_SIZE = 8 * MiB;
+static constexpr guint MAX_PARALLEL_RANGES = 8;
+static constexpr gint64 PROGRESS_INTERVAL = 100'000;
+static constexpr guint MAX_RETRY_BACKOFF_SHIFT = 5;
+
+typedef enum {
+    STATE_IDLE,
+    STATE_RUNNING,
+    STATE_FINISHED,
+    STATE_FAILED,
+} DownloadState;
+
+// A part of the file that's fetched (and written) front to back by a request of its own.
+typedef struct {
+    WebDownload *download;
+    guint64 start;
+    // One past the last byte, or 0 while the size isn't known.
+    guint64 end;
+    guint64 written;
+    guint retries;
+    gboolean done;
+
+    GInputStream *input;
+    GFileIOStream *file;
+    guint8 buffer[READ_CHUNK_SIZE];
+} Range;
+
+struct _WebDownload
+{
+    GObject parent_instance;
+
+    char *uri;
+    char *destination;
+    guint parallel_ranges;
+    guint max_retries;
+
+    DownloadState state;
+    GCancellable *cancellable;
+    GFile *part_file;
+    GPtrArray *ranges;
+    guint64 total;
+    // A strong ETag or a Last-Modified date, so every range is sure to come from the same version of the file.
+    char *validator;
+    gint64 last_progress;
+};
+
+G_DEFINE_FINAL_TYPE (WebDownload, web_download, G_TYPE_OBJECT)
+
+enum {
+    SIGNAL_PROGRESS,
+    SIGNAL_FINISHED,
+    SIGNAL_FAILED,
+    N_SIGNALS
+};
+
+static guint signals [N_SIGNALS];
+
+static void send_range (Range *range);
+static void read_next (Range *range);
+
+static SoupSession *
+download_session ()
+{
+    static SoupSession *session = nullptr;
+    if (!session) {
+        session = soup_session_new_with_options ("max-conns-per-host", MAX_PARALLEL_RANGES, nullptr);
+
+        // NOTE: Ranges count the bytes as they went over the wire, so nothing may be decoded on the way to the file.
+        soup_session_remove_feature_by_type (session, SOUP_TYPE_CONTENT_DECODER);
+    }
+    return session;
+}
+
+static void
+range_free (gpointer data)
+{
+    auto *range = static_cast<Range *>(data);
+    g_clear_object (&range->input);
+    g_clear_object (&range->file);
+    g_free (range);
+}
+
+static guint64
+received_bytes (WebDownload *self)
+{
+    guint64 received = 0;
+    for (guint i = 0; i < self->ranges->len; i++)
+        received += static_cast<Range *>(g_ptr_array_index (self->ranges, i))->written;
+    return received;
+}
+
+static void
+report_progress (WebDownload *self, gboolean force)
+{
+    auto now = g_get_monotonic_time ();
+    if (!force && now - self->last_progress < PROGRESS_INTERVAL)
+        return;
+
+    self->last_progress = now;
+    g_signal_emit (self, signals[SIGNAL_PROGRESS], 0, received_bytes (self), self->total);
+}
+
+// Takes ownership of error.
+static void
+fail (WebDownload *self, GError *error)
+{
+    if (self->state != STATE_RUNNING) {
+        g_error_free (error);
+        return;
+    }
+
+    self->state = STATE_FAILED;
+    g_cancellable_cancel (self->cancellable);
+
+    for (guint i = 0; i < self->ranges->len; i++) {
+        auto *range = static_cast<Range *>(g_ptr_array_index (self->ranges, i));
+        g_clear_object (&range->input);
+        g_clear_object (&range->file);
+    }
+    g_file_delete (self->part_file, nullptr, nullptr);
+
+    g_signal_emit (self, signals[SIGNAL_FAILED], 0, error);
+    g_error_free (error);
+}
+
+static void
+finish (WebDownload *self)
+{
+    GError *error = nullptr;
+
+    for (guint i = 0; i < self->ranges->len; i++) {
+        auto *range = static_cast<Range *>(g_ptr_array_index (self->ranges, i));
+        if (!g_io_stream_close (G_IO_STREAM (range->file), nullptr, &error)) {
+            fail (self, error);
+            return;
+        }
+        g_clear_object (&range->file);
+    }
+
+    g_autoptr (GFile) destination = g_file_new_for_path (self->destination);
+    if (!g_file_move (self->part_file, destination, G_FILE_COPY_OVERWRITE, nullptr, nullptr, nullptr, &error)) {
+        fail (self, error);
+        return;
+    }
+
+    self->state = STATE_FINISHED;
+    if (!self->total)
+        self->total = received_bytes (self);
+
+    report_progress (self, TRUE);
+    g_signal_emit (self, signals[SIGNAL_FINISHED], 0);
+}
+
+static void
+finish_range (Range *range)
+{
+    auto *self = range->download;
+    range->done = TRUE;
+
+    for (guint i = 0; i < self->ranges->len; i++) {
+        if (!static_cast<Range *>(g_ptr_array_index (self->ranges, i))->done)
+            return;
+    }
+    finish (self);
+}
+
+static gboolean
+retry_range (gpointer data)
+{
+    auto *range = static_cast<Range *>(data);
+    g_autoptr (WebDownload) self = range->download;
+
+    if (self->state == STATE_RUNNING)
+        send_range (range);
+    return G_SOURCE_REMOVE;
+}
+
+// Takes ownership of error.
+static void
+range_failed (Range *range, GError *error)
+{
+    auto *self = range->download;
+    g_clear_object (&range->input);
+
+    if (self->state != STATE_RUNNING) {
+        g_error_free (error);
+        return;
+    }
+
+    if (range->retries >= self->max_retries) {
+        fail (self, error);
+        return;
+    }
+
+    // Back off a little more every time, whatever broke the connection may take a moment to come back.
+    auto delay = 1u << MIN (range->retries, MAX_RETRY_BACKOFF_SHIFT);
+    range->retries++;
+    g_error_free (error);
+
+    g_object_ref (self);
+    g_timeout_add_seconds (delay, retry_range, range);
+}
+
+// Sets things up for the file the server just started sending us in full, and splits it up if it's worth it.
+static gboolean
+did_receive_entity (WebDownload *self, Range *range, SoupMessageHeaders *headers)
+{
+    auto content_length = soup_message_headers_get_content_length (headers);
+    self->total = content_length > 0 ? static_cast<guint64>(content_length) : 0;
+    range->end = self->total;
+
+    // NOTE: If-Range only takes strong validators.
+    g_clear_pointer (&self->validator, g_free);
+    auto const *etag = soup_message_headers_get_one (headers, "ETag");
+    auto const *last_modified = soup_message_headers_get_one (headers, "Last-Modified");
+    if (etag && !g_str_has_prefix (etag, "W/"))
+        self->validator = g_strdup (etag);
+    else if (last_modified)
+        self->validator = g_strdup (last_modified);
+
+    auto const *accept_ranges = soup_message_headers_get_list (headers, "Accept-Ranges");
+    auto supports_ranges = accept_ranges && soup_header_contains (accept_ranges, "bytes");
+    auto n_ranges = MIN (static_cast<guint64>(self->parallel_ranges), self->total / MIN_RANGE_SIZE);
+    if (!supports_ranges || !self->validator || soup_message_headers_get_one (headers, "Content-Encoding") || n_ranges < 2)
+        return TRUE;
+
+    // NOTE: Size the file up front, so every range can write at its own offset from the start.
+    GError *error = nullptr;
+    if (!g_seekable_truncate (G_SEEKABLE (range->file), self->total, nullptr, &error)) {
+        fail (self, error);
+        return FALSE;
+    }
+
+    // The first range carries on with the response we already have, the others need requests of their own.
+    auto range_size = self->total / n_ranges;
+    range->end = range_size;
+
+    for (guint64 i = 1; i < n_ranges; i++) {
+        auto *next = g_new0 (Range, 1);
+        next->download = self;
+        next->start = i * range_size;
+        next->end = i == n_ranges - 1 ? self->total : (i + 1) * range_size;
+        g_ptr_array_add (self->ranges, next);
+
+        next->file = g_file_open_readwrite (self->part_file, nullptr, &error);
+        if (!next->file || !g_seekable_seek (G_SEEKABLE (next->file), next->start, G_SEEK_SET, nullptr, &error)) {
+            fail (self, error);
+            return FALSE;
+        }
+        send_range (next);
+    }
+    return TRUE;
+}
+
+static void
+did_receive_response (GObject *source, GAsyncResult *result, gpointer data)
+{
+    auto *range = static_cast<Range *>(data);
+    g_autoptr (WebDownload) self = range->download;
+    auto *session = SOUP_SESSION (source);
+    auto *message = soup_session_get_async_result_message (session, result);
+
+    GError *error = nullptr;
+    auto *input = soup_session_send_finish (session, result, &error);
+    if (!input) {
+        range_failed (range, error);
+        return;
+    }
+    if (self->state != STATE_RUNNING) {
+        g_object_unref (input);
+        return;
+    }
+
+    auto status = soup_message_get_status (message);
+    auto asked_for_range = range->start + range->written > 0 || range->end;
+
+    if (status == SOUP_STATUS_PARTIAL_CONTENT && asked_for_range) {
+        // Right where we left off.
+    } else if (status == SOUP_STATUS_OK && self->ranges->len == 1) {
+        // Either this is the first response, or the server couldn't (or because the file changed, wouldn't) resume. Start over.
+        if (range->written) {
+            if (!g_seekable_seek (G_SEEKABLE (range->file), 0, G_SEEK_SET, nullptr, &error)
+                || !g_seekable_truncate (G_SEEKABLE (range->file), 0, nullptr, &error)) {
+                g_object_unref (input);
+                fail (self, error);
+                return;
+            }
+            range->written = 0;
+        }
+        if (!did_receive_entity (self, range, soup_message_get_response_headers (message))) {
+            g_object_unref (input);
+            return;
+        }
+    } else {
+        g_object_unref (input);
+        error = g_error_new (G_IO_ERROR, G_IO_ERROR_FAILED, "%s: HTTP %u %s", self->uri, status, soup_status_get_phrase (status));
+
+        // Server errors tend to go away again, anything else (including a file that changed under our other ranges) won't.
+        if (SOUP_STATUS_IS_SERVER_ERROR (status))
+            range_failed (range, error);
+        else
+            fail (self, error);
+        return;
+    }
+
+    range->input = input;
+    read_next (range);
+}
+
+static void
+did_write (GObject *source, GAsyncResult *result, gpointer data)
+{
+    auto *range = static_cast<Range *>(data);
+    g_autoptr (WebDownload) self = range->download;
+
+    gsize written = 0;
+    GError *error = nullptr;
+    if (!g_output_stream_write_all_finish (G_OUTPUT_STREAM (source), result, &written, &error)) {
+        // NOTE: Unlike the network, trying again won't make the disk any less full.
+        fail (self, error);
+        return;
+    }
+    if (self->state != STATE_RUNNING)
+        return;
+
+    range->written += written;
+    report_progress (self, FALSE);
+    read_next (range);
+}
+
+static void
+did_read (GObject *source, GAsyncResult *result, gpointer data)
+{
+    auto *range = static_cast<Range *>(data);
+    g_autoptr (WebDownload) self = range->download;
+
+    GError *error = nullptr;
+    auto size = g_input_stream_read_finish (G_INPUT_STREAM (source), result, &error);
+    if (size < 0) {
+        range_failed (range, error);
+        return;
+    }
+    if (self->state != STATE_RUNNING)
+        return;
+
+    if (size == 0) {
+        if (range->end && range->start + range->written < range->end) {
+            range_failed (range, g_error_new_literal (G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED, "The connection closed before the download was complete"));
+            return;
+        }
+        g_clear_object (&range->input);
+        finish_range (range);
+        return;
+    }
+
+    g_object_ref (self);
+    g_output_stream_write_all_async (g_io_stream_get_output_stream (G_IO_STREAM (range->file)),
+                                     range->buffer,
+                                     size,
+                                     G_PRIORITY_DEFAULT,
+                                     self->cancellable,
+                                     did_write,
+                                     range);
+}
+
+static void
+read_next (Range *range)
+{
+    auto *self = range->download;
+
+    gsize size = READ_CHUNK_SIZE;
+    if (range->end) {
+        auto remaining = range->end - range->start - range->written;
+        if (!remaining) {
+            // NOTE: The first of several ranges stops partway through its response, which costs us that connection. It's one out of many.
+            g_clear_object (&range->input);
+            finish_range (range);
+            return;
+        }
+        size = MIN (size, remaining);
+    }
+
+    g_object_ref (self);
+    g_input_stream_read_async (range->input,
+                               range->buffer,
+                               size,
+                               G_PRIORITY_DEFAULT,
+                               self->cancellable,
+                               did_read,
+                               range);
+}
+
+static void
+send_range (Range *range)
+{
+    auto *self = range->download;
+
+    auto *message = soup_message_new (SOUP_METHOD_GET, self->uri);
+    if (!message) {
+        fail (self, g_error_new (G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Unable to download %s", self->uri));
+        return;
+    }
+
+    soup_message_set_force_http1 (message, TRUE);
+
+    auto *headers = soup_message_get_request_headers (message);
+    soup_message_headers_replace (headers, "Accept-Encoding", "identity");
+
+    auto offset = range->start + range->written;
+    if (offset > 0 || range->end) {
+        soup_message_headers_set_range (headers, offset, range->end ? static_cast<goffset>(range->end - 1) : -1);
+        if (self->validator)
+            soup_message_headers_replace (headers, "If-Range", self->validator);
+    }
+
+    g_object_ref (self);
+    soup_session_send_async (download_session (),
+                             message,
+                             G_PRIORITY_DEFAULT,
+                             self->cancellable,
+                             did_receive_response,
+                             range);
+    g_object_unref (message);
+}
+
+WebDownload *
+web_download_new (const char *uri, const char *destination)
+{
+    g_return_val_if_fail (uri != nullptr, nullptr);
+    g_return_val_if_fail (destination != nullptr, nullptr);
+
+    auto *self = WEB_DOWNLOAD (g_object_new (WEB_TYPE_DOWNLOAD, NULL));
+    self->uri = g_strdup (uri);
+    self->destination = g_strdup (destination);
+    return self;
+}
+
+const char *
+web_download_get_uri (WebDownload *self)
+{
+    g_return_val_if_fail (WEB_IS_DOWNLOAD (self), nullptr);
+    return self->uri;
+}
+
+const char *
+web_download_get_destination (WebDownload *self)
+{
+    g_return_val_if_fail (WEB_IS_DOWNLOAD (self), nullptr);
+    return self->destination;
+}
+
+void
+web_download_set_parallel_ranges (WebDownload *self, guint n_ranges)
+{
+    g_return_if_fail (WEB_IS_DOWNLOAD (self));
+    self->parallel_ranges = CLAMP (n_ranges, 1u, MAX_PARALLEL_RANGES);
+}
+
+void
+web_download_set_max_retries (WebDownload *self, guint max_retries)
+{
+    g_return_if_fail (WEB_IS_DOWNLOAD (self));
+    self->max_retries = max_retries;
+}
+
+void
+web_download_start (WebDownload *self)
+{
+    g_return_if_fail (WEB_IS_DOWNLOAD (self));
+    g_return_if_fail (self->state == STATE_IDLE);
+
+    self->state = STATE_RUNNING;
+
+    // NOTE: Write next to the destination, so the final move is a rename and nobody sees half a file under the real name.
+    g_autofree char *part_path = g_strdup_printf ("%s.part", self->destination);
+    self->part_file = g_file_new_for_path (part_path);
+
+    GError *error = nullptr;
+    auto *file = g_file_replace_readwrite (self->part_file, nullptr, FALSE, G_FILE_CREATE_NONE, nullptr, &error);
+    if (!file) {
+        fail (self, error);
+        return;
+    }
+
+    auto *range = g_new0 (Range, 1);
+    range->download = self;
+    range->file = file;
+    g_ptr_array_add (self->ranges, range);
+
+    send_range (range);
+}
+
+void
+web_download_cancel (WebDownload *self)
+{
+    g_return_if_fail (WEB_IS_DOWNLOAD (self));
+    fail (self, g_error_new_literal (G_IO_ERROR, G_IO_ERROR_CANCELLED, "The download was cancelled"));
+}
+
+guint64
+web_download_get_received_bytes (WebDownload *self)
+{
+    g_return_val_if_fail (WEB_IS_DOWNLOAD (self), 0);
+    return received_bytes (self);
+}
+
+guint64
+web_download_get_total_bytes (WebDownload *self)
+{
+    g_return_val_if_fail (WEB_IS_DOWNLOAD (self), 0);
+    return self->total;
+}
+
+static void
+web_download_finalize (GObject *object)
+{
+    WebDownload *self = (WebDownload *)object;
+
+    g_free (self->uri);
+    g_free (self->destination);
+    g_free (self->validator);
+    g_clear_object (&self->part_file);
+    g_clear_object (&self->cancellable);
+    g_ptr_array_unref (self->ranges);
+
+    G_OBJECT_CLASS (web_download_parent_class)->finalize (object);
+}
+
+static void
+web_download_class_init (WebDownloadClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = web_download_finalize;
+
+    // Emitted every so often with the bytes received so far, and the total (or 0 if that isn't known).
+    signals[SIGNAL_PROGRESS] = g_signal_new ("progress",
+                                             G_TYPE_FROM_CLASS (klass),
+                                             G_SIGNAL_RUN_LAST,
+                                             0, NULL, NULL, NULL,
+                                             G_TYPE_NONE, 2,
+                                             G_TYPE_UINT64, G_TYPE_UINT64);
+
+    signals[SIGNAL_FINISHED] = g_signal_new ("finished",
+                                             G_TYPE_FROM_CLASS (klass),
+                                             G_SIGNAL_RUN_LAST,
+                                             0, NULL, NULL, NULL,
+                                             G_TYPE_NONE, 0);
+
+    signals[SIGNAL_FAILED] = g_signal_new ("failed",
+                                           G_TYPE_FROM_CLASS (klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 1,
+                                           G_TYPE_ERROR);
+}
+
+static void
+web_download_init (WebDownload *self)
+{
+    // NOTE: Every request, read, write and retry holds a reference, so a running download keeps itself alive.
+    self->parallel_ranges = 1;
+    self->max_retries = 5;
+    self->cancellable = g_cancellable_new ();
+    self->ranges = g_ptr_array_new_with_free_func (range_free);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define WEB_TYPE_DOWNLOAD (web_download_get_type())
+
+G_DECLARE_FINAL_TYPE (WebDownload, web_download, WEB, DOWNLOAD, GObject)
+
+/* Streams uri to destination, which only appears once the download has finished. */
+WebDownload *
+web_download_new (const char *uri, const char *destination);
+
+const char *
+web_download_get_uri (WebDownload *self);
+
+const char *
+web_download_get_destination (WebDownload *self);
+
+/* Splits large files into up to n_ranges requests made side by side, if the server supports ranges. 1 (the default) turns this off. */
+void
+web_download_set_parallel_ranges (WebDownload *self, guint n_ranges);
+
+/* How often a broken transfer is picked up again where it left off, before the download fails. */
+void
+web_download_set_max_retries (WebDownload *self, guint max_retries);
+
+void
+web_download_start (WebDownload *self);
+
+void
+web_download_cancel (WebDownload *self);
+
+guint64
+web_download_get_received_bytes (WebDownload *self);
+
+/* 0 while the size isn't known. */
+guint64
+web_download_get_total_bytes (WebDownload *self);
+
+G_END_DECLS
@@ -8,6 +8,7 @@
 #include "LibCore/EventLoopImplementation.h"
 #include "EventLoopImplementationGLib.h"
 #include "LibCore/EventLoop.h"
+#include "NetworkSettings.h"
 #include "Utilities.h"
 #include "LibGfx/Font/FontDatabase.h"
 
@@ -65,4 +66,69 @@ void web_embed_init()
     // NOTE: We only instantiate this to ensure that Gfx::FontDatabase has its default queries initialized.
     Gfx::FontDatabase::set_default_font_query("Katica 10 400 0");
     Gfx::FontDatabase::set_fixed_width_font_query("Csilla 10 400 0");
-}
\ No newline at end of file
+}
+
+void web_embed_set_http_cache_enabled(gboolean enabled)
+{
+    g_setenv(Ladybird::HTTP_CACHE_ENABLED_ENV, enabled ? "1" : "0", TRUE);
+}
+
+void web_embed_set_http_cache_directory(const char *directory)
+{
+    if (directory)
+        g_setenv(Ladybird::HTTP_CACHE_DIRECTORY_ENV, directory, TRUE);
+    else
+        g_unsetenv(Ladybird::HTTP_CACHE_DIRECTORY_ENV);
+}
+
+void web_embed_set_http_cache_limits(guint64 memory_size, guint64 disk_size)
+{
+    g_setenv(Ladybird::HTTP_CACHE_MEMORY_SIZE_ENV, AK::DeprecatedString::number(memory_size).characters(), TRUE);
+    g_setenv(Ladybird::HTTP_CACHE_DISK_SIZE_ENV, AK::DeprecatedString::number(disk_size).characters(), TRUE);
+}
+
+void web_embed_set_network_server_enabled(gboolean enabled)
+{
+    g_setenv(Ladybird::NETWORK_SERVER_ENABLED_ENV, enabled ? "1" : "0", TRUE);
+}
+
+void web_embed_set_preload_scanner_enabled(gboolean enabled)
+{
+    g_setenv(Ladybird::PRELOAD_SCANNER_ENV, enabled ? "1" : "0", TRUE);
+}
+
+void web_embed_set_connection_limits(guint max_connections, guint max_connections_per_host)
+{
+    g_setenv(Ladybird::MAX_CONNECTIONS_ENV, AK::DeprecatedString::number(max_connections).characters(), TRUE);
+    g_setenv(Ladybird::MAX_CONNECTIONS_PER_HOST_ENV, AK::DeprecatedString::number(max_connections_per_host).characters(), TRUE);
+}
+
+void web_embed_set_network_archive(WebNetworkArchiveMode mode, const char *path, gboolean replay_original_latency)
+{
+    if (mode == WEB_NETWORK_ARCHIVE_OFF || !path) {
+        g_unsetenv(Ladybird::NETWORK_ARCHIVE_ENV);
+        g_unsetenv(Ladybird::NETWORK_ARCHIVE_MODE_ENV);
+        g_unsetenv(Ladybird::NETWORK_ARCHIVE_LATENCY_ENV);
+        return;
+    }
+
+    g_setenv(Ladybird::NETWORK_ARCHIVE_ENV, path, TRUE);
+    g_setenv(Ladybird::NETWORK_ARCHIVE_MODE_ENV, mode == WEB_NETWORK_ARCHIVE_RECORD ? "record" : "replay", TRUE);
+    g_setenv(Ladybird::NETWORK_ARCHIVE_LATENCY_ENV, replay_original_latency ? "original" : "none", TRUE);
+}
+
+void web_embed_set_network_conditions(const WebNetworkConditions *conditions)
+{
+    if (!conditions) {
+        g_unsetenv(Ladybird::NETWORK_CONDITIONS_ENV);
+        return;
+    }
+
+    Ladybird::NetworkConditions network_conditions {
+        .latency_ms = conditions->latency_ms,
+        .download_throughput = conditions->download_throughput,
+        .upload_throughput = conditions->upload_throughput,
+        .failure_rate = CLAMP (conditions->failure_rate, 0.0, 1.0),
+    };
+    g_setenv(Ladybird::NETWORK_CONDITIONS_ENV, network_conditions.to_deprecated_string().characters(), TRUE);
+}
@@ -6,12 +6,44 @@
 
 #pragma once
 
+#include <glib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum {
+    WEB_NETWORK_ARCHIVE_OFF,
+    WEB_NETWORK_ARCHIVE_RECORD,
+    WEB_NETWORK_ARCHIVE_REPLAY,
+} WebNetworkArchiveMode;
+
+typedef struct {
+    guint latency_ms;
+    /* Bytes per second, 0 for unlimited. */
+    guint64 download_throughput;
+    guint64 upload_throughput;
+    /* Between 0 and 1. */
+    gdouble failure_rate;
+} WebNetworkConditions;
+
 void web_embed_init();
 
+// NOTE: Network settings are picked up by WebContent processes as they are spawned,
+//       so these should be called before creating any WebContentView.
+void web_embed_set_http_cache_enabled(gboolean enabled);
+void web_embed_set_http_cache_directory(const char *directory);
+void web_embed_set_http_cache_limits(guint64 memory_size, guint64 disk_size);
+void web_embed_set_network_server_enabled(gboolean enabled);
+// NOTE: Speculative fetches go into the HTTP cache, so this does nothing while the cache is disabled.
+void web_embed_set_preload_scanner_enabled(gboolean enabled);
+void web_embed_set_connection_limits(guint max_connections, guint max_connections_per_host);
+// NOTE: While replaying, requests for anything that wasn't recorded fail rather than go to the network.
+void web_embed_set_network_archive(WebNetworkArchiveMode mode, const char *path, gboolean replay_original_latency);
+// Emulates a slow or unreliable network for every view, pass NULL to turn it off again.
+// NOTE: Also see web_content_view_set_network_conditions() for changing them once views are running.
+void web_embed_set_network_conditions(const WebNetworkConditions *conditions);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
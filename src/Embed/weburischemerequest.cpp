@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "weburischemerequestprivate.h"
+#include <LibCore/AnonymousBuffer.h>
+
+static constexpr gsize STREAM_CHUNK_SIZE = 64 * KiB;
+
+struct _WebUriSchemeRequest
+{
+    GObject parent_instance;
+
+    // NOTE: Held on to manually, GObject instances aren't constructed like C++ objects.
+    Ladybird::EmbedClient *client;
+    i32 request_id;
+    char *uri;
+    char *content_type;
+    gboolean finished;
+
+    // Only while a stream is being read.
+    GInputStream *stream;
+    Core::AnonymousBuffer *buffer;
+    GByteArray *stream_data;
+};
+
+G_DEFINE_FINAL_TYPE (WebUriSchemeRequest, web_uri_scheme_request, G_TYPE_OBJECT)
+
+static void
+send_response (WebUriSchemeRequest *self, bool success, Core::AnonymousBuffer const& body)
+{
+    if (self->finished)
+        return;
+    self->finished = TRUE;
+
+    // NOTE: The content process may have gone away while the embedder was busy.
+    if (self->client->is_open())
+        self->client->async_finish_uri_scheme_request (self->request_id, success, self->content_type ? self->content_type : "", body);
+
+    g_clear_object (&self->stream);
+    g_clear_pointer (&self->stream_data, g_byte_array_unref);
+    delete self->buffer;
+    self->buffer = nullptr;
+}
+
+static void
+send_bytes (WebUriSchemeRequest *self, ReadonlyBytes bytes)
+{
+    // NOTE: An invalid buffer stands for an empty body.
+    if (bytes.is_empty()) {
+        send_response (self, true, {});
+        return;
+    }
+
+    // NOTE: This is the one copy the body sees, from here WebContent maps the same memory.
+    auto buffer_or_error = Core::AnonymousBuffer::create_with_size (bytes.size());
+    if (buffer_or_error.is_error()) {
+        dbgln("Unable to allocate {} bytes for {}: {}", bytes.size(), self->uri, buffer_or_error.error());
+        send_response (self, false, {});
+        return;
+    }
+
+    auto buffer = buffer_or_error.release_value();
+    bytes.copy_to ({ buffer.data<u8>(), buffer.size() });
+    send_response (self, true, buffer);
+}
+
+WebUriSchemeRequest *
+web_uri_scheme_request_new (Ladybird::EmbedClient& client, i32 request_id, const char *uri)
+{
+    auto *self = WEB_URI_SCHEME_REQUEST (g_object_new (WEB_TYPE_URI_SCHEME_REQUEST, NULL));
+    client.ref();
+    self->client = &client;
+    self->request_id = request_id;
+    self->uri = g_strdup (uri);
+    return self;
+}
+
+const char *
+web_uri_scheme_request_get_uri (WebUriSchemeRequest *self)
+{
+    g_return_val_if_fail (WEB_IS_URI_SCHEME_REQUEST (self), nullptr);
+    return self->uri;
+}
+
+void
+web_uri_scheme_request_finish (WebUriSchemeRequest *self, GBytes *bytes, const char *content_type)
+{
+    g_return_if_fail (WEB_IS_URI_SCHEME_REQUEST (self));
+    g_return_if_fail (bytes != nullptr);
+    g_return_if_fail (!self->finished && !self->stream);
+
+    self->content_type = g_strdup (content_type);
+
+    gsize size = 0;
+    auto const *data = static_cast<u8 const *>(g_bytes_get_data (bytes, &size));
+    send_bytes (self, { data, size });
+}
+
+static void read_next_chunk (WebUriSchemeRequest *self);
+
+static void
+did_read_all (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr (WebUriSchemeRequest) self = WEB_URI_SCHEME_REQUEST (user_data);
+
+    gsize bytes_read = 0;
+    g_autoptr (GError) error = nullptr;
+    if (!g_input_stream_read_all_finish (G_INPUT_STREAM (source), result, &bytes_read, &error) || bytes_read != self->buffer->size()) {
+        dbgln("Unable to read the response for {}: {}", self->uri, error ? error->message : "The stream ended early");
+        send_response (self, false, {});
+        return;
+    }
+
+    send_response (self, true, *self->buffer);
+}
+
+static void
+did_read_chunk (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr (WebUriSchemeRequest) self = WEB_URI_SCHEME_REQUEST (user_data);
+
+    g_autoptr (GError) error = nullptr;
+    g_autoptr (GBytes) chunk = g_input_stream_read_bytes_finish (G_INPUT_STREAM (source), result, &error);
+    if (!chunk) {
+        dbgln("Unable to read the response for {}: {}", self->uri, error->message);
+        send_response (self, false, {});
+        return;
+    }
+
+    gsize size = 0;
+    auto const *data = static_cast<guint8 const *>(g_bytes_get_data (chunk, &size));
+    if (size == 0) {
+        send_bytes (self, { self->stream_data->data, self->stream_data->len });
+        return;
+    }
+
+    g_byte_array_append (self->stream_data, data, size);
+    read_next_chunk (self);
+}
+
+static void
+read_next_chunk (WebUriSchemeRequest *self)
+{
+    g_input_stream_read_bytes_async (self->stream,
+                                     STREAM_CHUNK_SIZE,
+                                     G_PRIORITY_DEFAULT,
+                                     nullptr,
+                                     did_read_chunk,
+                                     g_object_ref (self));
+}
+
+void
+web_uri_scheme_request_finish_with_stream (WebUriSchemeRequest *self, GInputStream *stream, gint64 length, const char *content_type)
+{
+    g_return_if_fail (WEB_IS_URI_SCHEME_REQUEST (self));
+    g_return_if_fail (G_IS_INPUT_STREAM (stream));
+    g_return_if_fail (!self->finished && !self->stream);
+
+    self->content_type = g_strdup (content_type);
+    self->stream = G_INPUT_STREAM (g_object_ref (stream));
+
+    if (length == 0) {
+        send_response (self, true, {});
+        return;
+    }
+
+    if (length < 0) {
+        self->stream_data = g_byte_array_new ();
+        read_next_chunk (self);
+        return;
+    }
+
+    auto buffer_or_error = Core::AnonymousBuffer::create_with_size (length);
+    if (buffer_or_error.is_error()) {
+        dbgln("Unable to allocate {} bytes for {}: {}", length, self->uri, buffer_or_error.error());
+        send_response (self, false, {});
+        return;
+    }
+
+    // NOTE: With the length known, the stream is read straight into the shared memory.
+    self->buffer = new Core::AnonymousBuffer (buffer_or_error.release_value());
+    g_input_stream_read_all_async (self->stream,
+                                   self->buffer->data<void>(),
+                                   self->buffer->size(),
+                                   G_PRIORITY_DEFAULT,
+                                   nullptr,
+                                   did_read_all,
+                                   g_object_ref (self));
+}
+
+void
+web_uri_scheme_request_finish_error (WebUriSchemeRequest *self, GError *error)
+{
+    g_return_if_fail (WEB_IS_URI_SCHEME_REQUEST (self));
+    g_return_if_fail (!self->finished && !self->stream);
+
+    if (error)
+        dbgln("Unable to load {}: {}", self->uri, error->message);
+    send_response (self, false, {});
+}
+
+static void
+web_uri_scheme_request_finalize (GObject *object)
+{
+    WebUriSchemeRequest *self = (WebUriSchemeRequest *)object;
+
+    // NOTE: Dropping a request unanswered must not leave the page waiting forever.
+    send_response (self, false, {});
+
+    self->client->unref();
+    g_free (self->uri);
+    g_free (self->content_type);
+
+    G_OBJECT_CLASS (web_uri_scheme_request_parent_class)->finalize (object);
+}
+
+static void
+web_uri_scheme_request_class_init (WebUriSchemeRequestClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = web_uri_scheme_request_finalize;
+}
+
+static void
+web_uri_scheme_request_init (WebUriSchemeRequest *self)
+{
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define WEB_TYPE_URI_SCHEME_REQUEST (web_uri_scheme_request_get_type())
+
+G_DECLARE_FINAL_TYPE (WebUriSchemeRequest, web_uri_scheme_request, WEB, URI_SCHEME_REQUEST, GObject)
+
+const char *
+web_uri_scheme_request_get_uri (WebUriSchemeRequest *self);
+
+/* Exactly one of the finish functions must be called, whenever the response is ready.
+ * A request that is dropped unfinished fails. */
+void
+web_uri_scheme_request_finish (WebUriSchemeRequest *self, GBytes *bytes, const char *content_type);
+
+/* length is the number of bytes the stream will produce, or -1 if that isn't known up front.
+ * A known length lets the stream be read straight into the memory shared with the content process. */
+void
+web_uri_scheme_request_finish_with_stream (WebUriSchemeRequest *self, GInputStream *stream, gint64 length, const char *content_type);
+
+void
+web_uri_scheme_request_finish_error (WebUriSchemeRequest *self, GError *error);
+
+G_END_DECLS
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "weburischemerequest.h"
+#include "EmbedClient.h"
+
+WebUriSchemeRequest *
+web_uri_scheme_request_new (Ladybird::EmbedClient& client, i32 request_id, const char *uri);
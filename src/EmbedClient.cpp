@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "EmbedClient.h"
+#include "HelperProcess.h"
+#include <AK/DeprecatedString.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <glib.h>
+
+namespace Ladybird {
+
+static int s_web_content_socket_fd { -1 };
+
+ErrorOr<NonnullRefPtr<EmbedClient>> EmbedClient::try_create(NonnullOwnPtr<Core::LocalSocket> socket)
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EmbedClient(move(socket)));
+}
+
+EmbedClient::EmbedClient(NonnullOwnPtr<Core::LocalSocket> socket)
+    : IPC::ConnectionToServer<EmbedClientEndpoint, EmbedServerEndpoint>(*this, move(socket))
+{
+}
+
+void EmbedClient::die()
+{
+    // NOTE: A crashing WebContent process is handled through the LibWebView connection.
+}
+
+void EmbedClient::did_upload_progress(AK::URL const& url, u64 bytes_sent, u64 total_bytes)
+{
+    if (on_upload_progress)
+        on_upload_progress(url, bytes_sent, total_bytes);
+}
+
+void EmbedClient::did_request_uri_scheme(i32 request_id, AK::URL const& url)
+{
+    if (on_uri_scheme_request)
+        on_uri_scheme_request(request_id, url);
+    else
+        async_finish_uri_scheme_request(request_id, false, {}, {});
+}
+
+ErrorOr<NonnullOwnPtr<Core::LocalSocket>> EmbedClient::start_handing_over_socket()
+{
+    VERIFY(s_web_content_socket_fd == -1);
+
+    int socket_fds[2] {};
+    TRY(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, socket_fds));
+
+    int ui_fd = socket_fds[0];
+    s_web_content_socket_fd = socket_fds[1];
+
+    // Only the WebContent end may survive exec().
+    TRY(Core::System::fcntl(ui_fd, F_SETFD, FD_CLOEXEC));
+    g_setenv(EMBED_SOCKET_FD_ENV, DeprecatedString::number(s_web_content_socket_fd).characters(), TRUE);
+
+    return Core::LocalSocket::adopt_fd(ui_fd);
+}
+
+void EmbedClient::finish_handing_over_socket()
+{
+    g_unsetenv(EMBED_SOCKET_FD_ENV);
+
+    if (s_web_content_socket_fd != -1) {
+        MUST(Core::System::close(s_web_content_socket_fd));
+        s_web_content_socket_fd = -1;
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibIPC/ConnectionToServer.h>
+#include <WebContent/EmbedClientEndpoint.h>
+#include <WebContent/EmbedServerEndpoint.h>
+
+namespace Ladybird {
+
+class EmbedClient final
+    : public IPC::ConnectionToServer<EmbedClientEndpoint, EmbedServerEndpoint>
+    , public EmbedClientEndpoint {
+public:
+    static ErrorOr<NonnullRefPtr<EmbedClient>> try_create(NonnullOwnPtr<Core::LocalSocket>);
+
+    virtual ~EmbedClient() override = default;
+
+    // NOTE: LibWebView spawns the WebContent process on our behalf, so we can't hand it a socket directly.
+    //       Instead, the WebContent end of the socket pair is inherited, and its number passed through the environment.
+    //       This must be called right before, and finish_handing_over_socket() right after, spawning WebContent.
+    static ErrorOr<NonnullOwnPtr<Core::LocalSocket>> start_handing_over_socket();
+    static void finish_handing_over_socket();
+
+    Function<void(AK::URL const&, u64 bytes_sent, u64 total_bytes)> on_upload_progress;
+    Function<void(i32 request_id, AK::URL const&)> on_uri_scheme_request;
+
+private:
+    explicit EmbedClient(NonnullOwnPtr<Core::LocalSocket>);
+
+    virtual void die() override;
+
+    virtual void did_upload_progress(AK::URL const&, u64 bytes_sent, u64 total_bytes) override;
+    virtual void did_request_uri_scheme(i32 request_id, AK::URL const&) override;
+};
+
+}
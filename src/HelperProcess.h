@@ -12,5 +12,11 @@
 #include <AK/StringView.h>
 #include <LibCore/System.h>
 
+// The file descriptor of WebContent's end of the socket to the embedding application, see EmbedClient.
+static constexpr char const* EMBED_SOCKET_FD_ENV = "LIBWEB_GTK_EMBED_SOCKET_FD";
+
+// The path of the application's NetworkServer socket, when WebContent should load through it, see NetworkServerClient.
+static constexpr char const* NETWORK_SERVER_SOCKET_ENV = "LIBWEB_GTK_NETWORK_SERVER_SOCKET";
+
 ErrorOr<void> spawn_helper_process(StringView process_name, ReadonlySpan<StringView> arguments, Core::System::SearchInPath, Optional<ReadonlySpan<StringView>> environment = {});
 ErrorOr<Vector<String>> get_paths_for_helper_process(StringView process_name);
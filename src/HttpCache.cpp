@@ -0,0 +1,693 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "HttpCache.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/Directory.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace Ladybird {
+
+static constexpr u32 DISK_FORMAT_VERSION = 1;
+
+// RFC 9111 4.2.2: A common heuristic is 10% of the time since the resource was last modified. We cap it at one day.
+static constexpr i64 MAX_HEURISTIC_FRESHNESS = 24 * 60 * 60;
+
+static bool is_heuristically_cacheable(u32 status_code)
+{
+    // RFC 9110 15.1: Status codes that are cacheable by default.
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool is_stored_header(StringView name)
+{
+    // Hop-by-hop fields only apply to a single connection, and cookies must never be replayed from the cache.
+    return !name.is_one_of_ignoring_ascii_case(
+        "connection"sv,
+        "keep-alive"sv,
+        "proxy-authenticate"sv,
+        "proxy-authorization"sv,
+        "proxy-connection"sv,
+        "te"sv,
+        "trailer"sv,
+        "transfer-encoding"sv,
+        "upgrade"sv,
+        "set-cookie"sv,
+        "set-cookie2"sv);
+}
+
+static Optional<i64> parse_http_date(DeprecatedString const& value)
+{
+    GDateTime* date = soup_date_time_new_from_http_string(value.characters());
+    if (!date)
+        return {};
+
+    auto seconds = g_date_time_to_unix(date);
+    g_date_time_unref(date);
+    return seconds;
+}
+
+static Optional<DeprecatedString> find_request_header(HashMap<DeprecatedString, DeprecatedString> const& request_headers, StringView name)
+{
+    for (auto const& it : request_headers) {
+        if (it.key.equals_ignoring_ascii_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+static Vector<HttpCache::Header> stored_headers_from_soup(SoupMessageHeaders* soup_headers)
+{
+    Vector<HttpCache::Header> headers;
+
+    SoupMessageHeadersIter iter;
+    char const *c_name, *c_value;
+
+    soup_message_headers_iter_init(&iter, soup_headers);
+    while (soup_message_headers_iter_next(&iter, &c_name, &c_value)) {
+        StringView name { c_name, strlen(c_name) };
+        if (is_stored_header(name))
+            headers.append({ name, DeprecatedString(c_value) });
+    }
+
+    return headers;
+}
+
+static JsonArray headers_to_json(Vector<HttpCache::Header> const& headers)
+{
+    JsonArray array;
+    for (auto const& header : headers) {
+        JsonArray pair;
+        pair.must_append(header.name);
+        pair.must_append(header.value);
+        array.must_append(move(pair));
+    }
+    return array;
+}
+
+static Vector<HttpCache::Header> headers_from_json(Optional<JsonArray const&> array)
+{
+    Vector<HttpCache::Header> headers;
+    if (!array.has_value())
+        return headers;
+
+    array->for_each([&](JsonValue const& value) {
+        if (!value.is_array() || value.as_array().size() != 2)
+            return;
+        auto const& pair = value.as_array();
+        if (!pair.at(0).is_string() || !pair.at(1).is_string())
+            return;
+        headers.append({ pair.at(0).as_string(), pair.at(1).as_string() });
+    });
+    return headers;
+}
+
+HttpCache::CacheControl HttpCache::CacheControl::parse(StringView value)
+{
+    CacheControl cache_control;
+
+    for (auto directive : value.split_view(',')) {
+        directive = directive.trim_whitespace();
+
+        auto name = directive;
+        Optional<StringView> argument;
+        if (auto equals = directive.find('='); equals.has_value()) {
+            name = directive.substring_view(0, *equals).trim_whitespace();
+            argument = directive.substring_view(*equals + 1).trim_whitespace().trim("\""sv);
+        }
+
+        if (name.equals_ignoring_ascii_case("no-store"sv)) {
+            cache_control.no_store = true;
+        } else if (name.equals_ignoring_ascii_case("no-cache"sv)) {
+            cache_control.no_cache = true;
+        } else if (name.equals_ignoring_ascii_case("must-revalidate"sv)) {
+            cache_control.must_revalidate = true;
+        } else if (name.equals_ignoring_ascii_case("public"sv)) {
+            cache_control.is_public = true;
+        } else if (name.equals_ignoring_ascii_case("max-age"sv) && argument.has_value()) {
+            // RFC 9111 1.2.2: Values that overflow are treated as the largest representable delta.
+            auto seconds = argument->to_uint<u64>();
+            if (seconds.has_value())
+                cache_control.max_age = static_cast<i64>(min(*seconds, static_cast<u64>(NumericLimits<i32>::max())));
+        }
+    }
+
+    return cache_control;
+}
+
+NonnullRefPtr<HttpCache::Entry> HttpCache::Entry::create(u32 status_code, Vector<Header> response_headers, Vector<Header> vary_headers, GBytes* body, i64 request_time, i64 response_time)
+{
+    return adopt_ref(*new Entry(status_code, move(response_headers), move(vary_headers), body, request_time, response_time));
+}
+
+HttpCache::Entry::Entry(u32 status_code, Vector<Header> response_headers, Vector<Header> vary_headers, GBytes* body, i64 request_time, i64 response_time)
+    : m_status_code(status_code)
+    , m_response_headers(move(response_headers))
+    , m_vary_headers(move(vary_headers))
+    , m_body(g_bytes_ref(body))
+    , m_request_time(request_time)
+    , m_response_time(response_time)
+{
+    m_date_value = response_time;
+    if (auto date = header("Date"sv); date.has_value())
+        m_date_value = parse_http_date(*date).value_or(response_time);
+
+    if (auto age = header("Age"sv); age.has_value())
+        m_age_value = static_cast<i64>(age->to_uint<u32>().value_or(0));
+
+    m_etag = header("ETag"sv).value_or({});
+    m_last_modified = header("Last-Modified"sv).value_or({});
+
+    auto cache_control_header = header("Cache-Control"sv);
+    auto cache_control = CacheControl::parse(cache_control_header.value_or({}));
+
+    m_always_revalidate = cache_control.no_cache;
+    if (!cache_control_header.has_value()) {
+        // RFC 9111 5.4: Pragma: no-cache is only honoured when Cache-Control is absent.
+        auto pragma = header("Pragma"sv);
+        m_always_revalidate = pragma.has_value() && pragma->contains("no-cache"sv, CaseSensitivity::CaseInsensitive);
+    }
+
+    // RFC 9111 4.2.1: Calculating Freshness Lifetime. We are a private cache, so s-maxage is ignored.
+    if (cache_control.max_age.has_value()) {
+        m_freshness_lifetime = *cache_control.max_age;
+    } else if (auto expires = header("Expires"sv); expires.has_value()) {
+        // NOTE: An invalid Expires value (such as "0") means the response is already stale.
+        auto expires_value = parse_http_date(*expires);
+        m_freshness_lifetime = expires_value.has_value() ? max<i64>(0, *expires_value - m_date_value) : 0;
+    } else if (!m_last_modified.is_null() && is_heuristically_cacheable(status_code)) {
+        if (auto last_modified = parse_http_date(m_last_modified); last_modified.has_value())
+            m_freshness_lifetime = min(max<i64>(0, (m_date_value - *last_modified) / 10), MAX_HEURISTIC_FRESHNESS);
+    }
+}
+
+HttpCache::Entry::~Entry()
+{
+    g_bytes_unref(m_body);
+}
+
+Optional<DeprecatedString> HttpCache::Entry::header(StringView name) const
+{
+    Optional<DeprecatedString> result;
+    for (auto const& header : m_response_headers) {
+        if (!header.name.equals_ignoring_ascii_case(name))
+            continue;
+        // RFC 9110 5.3: Repeated fields are combined into a comma-separated list.
+        if (result.has_value())
+            result = DeprecatedString::formatted("{}, {}", *result, header.value);
+        else
+            result = header.value;
+    }
+    return result;
+}
+
+HttpCache::HeaderMap const& HttpCache::Entry::header_map() const
+{
+    if (m_header_map.has_value())
+        return *m_header_map;
+
+    HeaderMap map;
+    map.ensure_capacity(m_response_headers.size());
+    for (auto const& header : m_response_headers) {
+        // RFC 9110 5.3: Repeated fields are combined into a comma-separated list.
+        if (auto it = map.find(header.name); it != map.end())
+            it->value = DeprecatedString::formatted("{}, {}", it->value, header.value);
+        else
+            map.set(header.name, header.value);
+    }
+    m_header_map = move(map);
+    return *m_header_map;
+}
+
+i64 HttpCache::Entry::current_age(i64 now) const
+{
+    // RFC 9111 4.2.3: Calculating Age
+    auto apparent_age = max<i64>(0, m_response_time - m_date_value);
+    auto response_delay = m_response_time - m_request_time;
+    auto corrected_age_value = m_age_value + response_delay;
+    auto corrected_initial_age = max(apparent_age, corrected_age_value);
+    auto resident_time = now - m_response_time;
+    return corrected_initial_age + resident_time;
+}
+
+bool HttpCache::Entry::is_fresh(i64 now, Optional<i64> max_age_from_request) const
+{
+    if (m_always_revalidate)
+        return false;
+
+    auto age = current_age(now);
+    if (max_age_from_request.has_value() && age > *max_age_from_request)
+        return false;
+
+    return m_freshness_lifetime > age;
+}
+
+static size_t memory_cost(HttpCache::Entry const& entry)
+{
+    size_t cost = entry.body_size();
+    for (auto const& header : entry.response_headers())
+        cost += header.name.length() + header.value.length();
+    return cost;
+}
+
+HttpCache::HttpCache(Configuration configuration)
+    : m_configuration(move(configuration))
+    , m_disk_writes_cancellable(g_cancellable_new())
+{
+    if (m_configuration.disk_size == 0)
+        return;
+
+    auto directory_or_error = Core::Directory::create(m_configuration.directory, Core::Directory::CreateDirectories::Yes);
+    if (directory_or_error.is_error()) {
+        dbgln("Unable to create HTTP cache directory {}: {}", m_configuration.directory, directory_or_error.error());
+        m_configuration.disk_size = 0;
+    }
+}
+
+HttpCache::~HttpCache()
+{
+    // NOTE: Writes already running still finish, and their files are fine to keep. Only their callbacks are cut off.
+    g_cancellable_cancel(m_disk_writes_cancellable);
+    g_object_unref(m_disk_writes_cancellable);
+}
+
+i64 HttpCache::current_time()
+{
+    return g_get_real_time() / G_USEC_PER_SEC;
+}
+
+DeprecatedString HttpCache::key_for_url(AK::URL const& url)
+{
+    return url.serialize(AK::URL::ExcludeFragment::Yes);
+}
+
+DeprecatedString HttpCache::path_for_key(DeprecatedString const& key) const
+{
+    auto* checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key.characters(), key.length());
+    auto path = DeprecatedString::formatted("{}/{}", m_configuration.directory, checksum);
+    g_free(checksum);
+    return path;
+}
+
+void HttpCache::did_hit(Tier tier)
+{
+    switch (tier) {
+    case Tier::Memory:
+        ++m_statistics.memory_hits;
+        break;
+    case Tier::Disk:
+        ++m_statistics.disk_hits;
+        break;
+    }
+}
+
+Optional<HttpCache::Lookup> HttpCache::lookup(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    auto key = key_for_url(url);
+
+    RefPtr<Entry> entry;
+    auto tier = Tier::Memory;
+
+    if (auto it = m_memory_entries.find(key); it != m_memory_entries.end()) {
+        entry = it->value;
+    } else {
+        entry = load_from_disk(key);
+        tier = Tier::Disk;
+    }
+
+    if (!entry)
+        return {};
+
+    // RFC 9111 4.1: Every field nominated by Vary must match the request that produced the stored response.
+    for (auto const& vary : entry->vary_headers()) {
+        if (find_request_header(request_headers, vary.name).value_or(DeprecatedString::empty()) != vary.value)
+            return {};
+    }
+
+    if (tier == Tier::Disk)
+        insert_into_memory(key, *entry);
+    else
+        entry->m_last_access = ++m_access_counter;
+
+    return Lookup { entry.release_nonnull(), tier };
+}
+
+void HttpCache::store(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, u32 status_code, SoupMessageHeaders* response_headers, GBytes* body, i64 request_time, i64 response_time)
+{
+    // RFC 9111 3: Storing Responses in Caches
+    if (status_code < 200 || status_code == 206 || status_code == 304)
+        return;
+
+    auto request_cache_control = CacheControl::parse(find_request_header(request_headers, "Cache-Control"sv).value_or({}));
+    if (request_cache_control.no_store)
+        return;
+
+    auto const* cache_control_header = soup_message_headers_get_list(response_headers, "Cache-Control");
+    auto response_cache_control = CacheControl::parse(cache_control_header ? StringView { cache_control_header, strlen(cache_control_header) } : StringView {});
+    if (response_cache_control.no_store)
+        return;
+
+    // RFC 9111 3.5: Responses to authenticated requests are only stored when explicitly allowed.
+    if (find_request_header(request_headers, "Authorization"sv).has_value() && !response_cache_control.is_public && !response_cache_control.must_revalidate)
+        return;
+
+    auto has_explicit_freshness = response_cache_control.max_age.has_value() || soup_message_headers_get_one(response_headers, "Expires");
+    if (!has_explicit_freshness && !is_heuristically_cacheable(status_code))
+        return;
+
+    Vector<Header> vary_headers;
+    if (auto const* vary = soup_message_headers_get_list(response_headers, "Vary")) {
+        for (auto name : StringView { vary, strlen(vary) }.split_view(',')) {
+            name = name.trim_whitespace();
+            if (name == "*"sv)
+                return;
+            vary_headers.append({ name, find_request_header(request_headers, name).value_or(DeprecatedString::empty()) });
+        }
+    }
+
+    auto entry = Entry::create(status_code, stored_headers_from_soup(response_headers), move(vary_headers), body, request_time, response_time);
+
+    // A response we can neither reuse nor revalidate isn't worth keeping around.
+    if (entry->m_freshness_lifetime <= 0 && !entry->has_validators())
+        return;
+
+    auto key = key_for_url(url);
+    ++m_statistics.stores;
+    insert_into_memory(key, entry);
+    write_to_disk(key, entry);
+}
+
+NonnullRefPtr<HttpCache::Entry> HttpCache::freshen(AK::URL const& url, Entry const& stale_entry, SoupMessageHeaders* not_modified_headers, i64 request_time, i64 response_time)
+{
+    // RFC 9111 4.3.4: Fields in the 304 response replace the corresponding fields of the stored response.
+    auto updated_headers = stored_headers_from_soup(not_modified_headers);
+    updated_headers.remove_all_matching([](auto const& header) {
+        return header.name.equals_ignoring_ascii_case("content-length"sv);
+    });
+
+    auto response_headers = stale_entry.response_headers();
+    response_headers.remove_all_matching([&](auto const& header) {
+        for (auto const& updated_header : updated_headers) {
+            if (updated_header.name.equals_ignoring_ascii_case(header.name))
+                return true;
+        }
+        return false;
+    });
+    response_headers.extend(move(updated_headers));
+
+    auto entry = Entry::create(stale_entry.status_code(), move(response_headers), stale_entry.vary_headers(), stale_entry.body(), request_time, response_time);
+
+    auto key = key_for_url(url);
+    insert_into_memory(key, entry);
+    write_to_disk(key, entry);
+
+    return entry;
+}
+
+void HttpCache::invalidate(AK::URL const& url)
+{
+    // RFC 9111 4.4: Unsafe methods invalidate the stored response for the target URI.
+    auto key = key_for_url(url);
+    remove_from_memory(key);
+
+    if (m_configuration.disk_size != 0)
+        (void)g_unlink(path_for_key(key).characters());
+}
+
+void HttpCache::insert_into_memory(DeprecatedString const& key, NonnullRefPtr<Entry> entry)
+{
+    remove_from_memory(key);
+
+    auto cost = memory_cost(*entry);
+    if (cost > m_configuration.memory_size / 8)
+        return;
+
+    entry->m_last_access = ++m_access_counter;
+    m_memory_entries.set(key, move(entry));
+    m_statistics.memory_size += cost;
+
+    evict_memory_if_needed();
+}
+
+void HttpCache::remove_from_memory(DeprecatedString const& key)
+{
+    auto it = m_memory_entries.find(key);
+    if (it == m_memory_entries.end())
+        return;
+
+    m_statistics.memory_size -= memory_cost(*it->value);
+    m_memory_entries.remove(it);
+}
+
+void HttpCache::evict_memory_if_needed()
+{
+    while (m_statistics.memory_size > m_configuration.memory_size && !m_memory_entries.is_empty()) {
+        auto least_recently_used = m_memory_entries.begin();
+        for (auto it = m_memory_entries.begin(); it != m_memory_entries.end(); ++it) {
+            if (it->value->m_last_access < least_recently_used->value->m_last_access)
+                least_recently_used = it;
+        }
+
+        m_statistics.memory_size -= memory_cost(*least_recently_used->value);
+        m_memory_entries.remove(least_recently_used);
+        ++m_statistics.evictions;
+    }
+}
+
+RefPtr<HttpCache::Entry> HttpCache::load_from_disk(DeprecatedString const& key)
+{
+    if (m_configuration.disk_size == 0)
+        return nullptr;
+
+    auto path = path_for_key(key);
+    GMappedFile* file = g_mapped_file_new(path.characters(), FALSE, nullptr);
+    if (!file)
+        return nullptr;
+
+    GBytes* contents = g_mapped_file_get_bytes(file);
+    g_mapped_file_unref(file);
+    ScopeGuard unref_contents = [&] { g_bytes_unref(contents); };
+
+    // Entries are stored as a single line of JSON metadata followed by the response body.
+    gsize size = 0;
+    auto const* data = static_cast<char const*>(g_bytes_get_data(contents, &size));
+    auto const* newline = data ? static_cast<char const*>(memchr(data, '\n', size)) : nullptr;
+    if (!newline)
+        return nullptr;
+
+    auto metadata_or_error = JsonValue::from_string(StringView { data, static_cast<size_t>(newline - data) });
+    if (metadata_or_error.is_error() || !metadata_or_error.value().is_object())
+        return nullptr;
+    auto const& metadata = metadata_or_error.value().as_object();
+
+    auto version = metadata.get_u32("version"sv);
+    auto url = metadata.get_deprecated_string("url"sv);
+    if (!version.has_value() || *version != DISK_FORMAT_VERSION || !url.has_value() || *url != key)
+        return nullptr;
+
+    auto status_code = metadata.get_u32("status"sv);
+    auto request_time = metadata.get_i64("request_time"sv);
+    auto response_time = metadata.get_i64("response_time"sv);
+    if (!status_code.has_value() || !request_time.has_value() || !response_time.has_value())
+        return nullptr;
+
+    auto body_offset = static_cast<gsize>(newline - data) + 1;
+    GBytes* body = g_bytes_new_from_bytes(contents, body_offset, size - body_offset);
+    ScopeGuard unref_body = [&] { g_bytes_unref(body); };
+
+    // NOTE: The modification time doubles as the last access time when evicting from disk.
+    (void)g_utime(path.characters(), nullptr);
+
+    return Entry::create(*status_code, headers_from_json(metadata.get_array("headers"sv)), headers_from_json(metadata.get_array("vary"sv)), body, *request_time, *response_time);
+}
+
+struct DiskWriteJob {
+    gchar* directory { nullptr };
+    gchar* path { nullptr };
+    GBytes* metadata { nullptr };
+    GBytes* body { nullptr };
+
+    bool scan_for_eviction { false };
+    u64 disk_size_limit { 0 };
+
+    u64 disk_size { 0 };
+    u64 evictions { 0 };
+};
+
+static void free_disk_write_job(gpointer data)
+{
+    auto* job = static_cast<DiskWriteJob*>(data);
+    g_free(job->directory);
+    g_free(job->path);
+    g_bytes_unref(job->metadata);
+    g_bytes_unref(job->body);
+    delete job;
+}
+
+static bool write_bytes(int fd, GBytes* bytes)
+{
+    gsize size = 0;
+    auto const* data = static_cast<u8 const*>(g_bytes_get_data(bytes, &size));
+    while (size > 0) {
+        auto nwritten = write(fd, data, size);
+        if (nwritten < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += nwritten;
+        size -= nwritten;
+    }
+    return true;
+}
+
+static void evict_disk_entries(DiskWriteJob& job)
+{
+    struct DiskEntry {
+        DeprecatedString path;
+        u64 size { 0 };
+        i64 last_access { 0 };
+    };
+
+    GDir* directory = g_dir_open(job.directory, 0, nullptr);
+    if (!directory)
+        return;
+
+    Vector<DiskEntry> entries;
+    u64 total_size = 0;
+
+    while (auto const* name = g_dir_read_name(directory)) {
+        // Skip temporary files that are still being written.
+        if (strchr(name, '.'))
+            continue;
+
+        auto path = DeprecatedString::formatted("{}/{}", job.directory, name);
+        GStatBuf stat_buffer;
+        if (g_stat(path.characters(), &stat_buffer) != 0 || !S_ISREG(stat_buffer.st_mode))
+            continue;
+
+        total_size += stat_buffer.st_size;
+        entries.append({ move(path), static_cast<u64>(stat_buffer.st_size), static_cast<i64>(stat_buffer.st_mtime) });
+    }
+    g_dir_close(directory);
+
+    if (total_size > job.disk_size_limit) {
+        quick_sort(entries, [](auto const& a, auto const& b) { return a.last_access < b.last_access; });
+
+        // Evict down to 90% of the limit, so that we aren't rescanning the directory on every store.
+        auto target_size = job.disk_size_limit / 10 * 9;
+        for (auto const& entry : entries) {
+            if (total_size <= target_size)
+                break;
+            if (g_unlink(entry.path.characters()) == 0) {
+                total_size -= entry.size;
+                ++job.evictions;
+            }
+        }
+    }
+
+    job.disk_size = total_size;
+}
+
+static void write_to_disk_in_thread(GTask* task, gpointer, gpointer task_data, GCancellable*)
+{
+    auto& job = *static_cast<DiskWriteJob*>(task_data);
+
+    // NOTE: Other WebContent processes share the cache directory, so we write into a temporary
+    //       file and rename it into place. Readers never observe a partially written entry.
+    auto* temporary_path = g_strdup_printf("%s.XXXXXX", job.path);
+    auto fd = g_mkstemp(temporary_path);
+    if (fd >= 0) {
+        auto success = write_bytes(fd, job.metadata) && write_bytes(fd, job.body);
+        close(fd);
+
+        if (!success || g_rename(temporary_path, job.path) != 0)
+            (void)g_unlink(temporary_path);
+    }
+    g_free(temporary_path);
+
+    if (job.scan_for_eviction)
+        evict_disk_entries(job);
+
+    g_task_return_boolean(task, TRUE);
+}
+
+void HttpCache::did_write_to_disk(GObject*, GAsyncResult* result, gpointer user_data)
+{
+    if (g_cancellable_is_cancelled(g_task_get_cancellable(G_TASK(result))))
+        return;
+
+    auto& self = *static_cast<HttpCache*>(user_data);
+    auto const& job = *static_cast<DiskWriteJob*>(g_task_get_task_data(G_TASK(result)));
+
+    if (job.scan_for_eviction) {
+        self.m_disk_size_estimate = job.disk_size;
+        self.m_statistics.evictions += job.evictions;
+    }
+    self.m_statistics.disk_size = self.m_disk_size_estimate;
+}
+
+void HttpCache::write_to_disk(DeprecatedString const& key, Entry const& entry)
+{
+    if (m_configuration.disk_size == 0)
+        return;
+
+    JsonObject metadata;
+    metadata.set("version"sv, DISK_FORMAT_VERSION);
+    metadata.set("url"sv, key);
+    metadata.set("status"sv, entry.status_code());
+    metadata.set("request_time"sv, entry.request_time());
+    metadata.set("response_time"sv, entry.response_time());
+    metadata.set("headers"sv, headers_to_json(entry.response_headers()));
+    metadata.set("vary"sv, headers_to_json(entry.vary_headers()));
+    auto serialized_metadata = DeprecatedString::formatted("{}\n", metadata.to_deprecated_string());
+
+    auto size = serialized_metadata.length() + entry.body_size();
+    if (size > m_configuration.disk_size / 8)
+        return;
+
+    m_disk_size_estimate += size;
+
+    // NOTE: The worker thread must not touch any AK objects owned by us, so everything is handed over as GLib types.
+    auto* job = new DiskWriteJob;
+    job->directory = g_strdup(m_configuration.directory.characters());
+    job->path = g_strdup(path_for_key(key).characters());
+    job->metadata = g_bytes_new(serialized_metadata.characters(), serialized_metadata.length());
+    job->body = g_bytes_ref(entry.body());
+    job->disk_size_limit = m_configuration.disk_size;
+    job->scan_for_eviction = !m_has_scanned_disk || m_disk_size_estimate > m_configuration.disk_size;
+    if (job->scan_for_eviction)
+        m_has_scanned_disk = true;
+
+    GTask* task = g_task_new(nullptr, m_disk_writes_cancellable, did_write_to_disk, this);
+    g_task_set_task_data(task, job, free_disk_write_job);
+    g_task_run_in_thread(task, write_to_disk_in_thread);
+    g_object_unref(task);
+}
+
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <libsoup/soup.h>
+
+namespace Ladybird {
+
+// A private HTTP cache as described by RFC 9111.
+// Each WebContent process keeps a small memory tier in front of a disk tier, which is shared by all processes.
+class HttpCache {
+public:
+    struct Configuration {
+        DeprecatedString directory;
+        u64 memory_size { 0 };
+        u64 disk_size { 0 };
+    };
+
+    // NOTE: Every lookup counts once: as a hit, as a revalidation if a conditional request went out, or as a miss.
+    struct Statistics {
+        u64 memory_hits { 0 };
+        u64 disk_hits { 0 };
+        u64 revalidations { 0 };
+        u64 misses { 0 };
+        u64 stores { 0 };
+        u64 evictions { 0 };
+        u64 memory_size { 0 };
+        u64 disk_size { 0 };
+    };
+
+    struct CacheControl {
+        static CacheControl parse(StringView);
+
+        bool no_store { false };
+        bool no_cache { false };
+        bool must_revalidate { false };
+        bool is_public { false };
+        Optional<i64> max_age;
+    };
+
+    struct Header {
+        DeprecatedString name;
+        DeprecatedString value;
+    };
+
+    // NOTE: This is the shape LibWeb wants response headers in.
+    using HeaderMap = HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits>;
+
+    class Entry : public RefCounted<Entry> {
+    public:
+        static NonnullRefPtr<Entry> create(u32 status_code, Vector<Header> response_headers, Vector<Header> vary_headers, GBytes* body, i64 request_time, i64 response_time);
+        ~Entry();
+
+        u32 status_code() const { return m_status_code; }
+        Vector<Header> const& response_headers() const { return m_response_headers; }
+        Vector<Header> const& vary_headers() const { return m_vary_headers; }
+        GBytes* body() const { return m_body; }
+        size_t body_size() const { return g_bytes_get_size(m_body); }
+        i64 request_time() const { return m_request_time; }
+        i64 response_time() const { return m_response_time; }
+
+        Optional<DeprecatedString> header(StringView name) const;
+        HeaderMap const& header_map() const;
+        DeprecatedString const& etag() const { return m_etag; }
+        DeprecatedString const& last_modified() const { return m_last_modified; }
+        bool has_validators() const { return !m_etag.is_null() || !m_last_modified.is_null(); }
+
+        i64 current_age(i64 now) const;
+        bool is_fresh(i64 now, Optional<i64> max_age_from_request = {}) const;
+
+    private:
+        Entry(u32 status_code, Vector<Header> response_headers, Vector<Header> vary_headers, GBytes* body, i64 request_time, i64 response_time);
+
+        u32 m_status_code { 0 };
+        Vector<Header> m_response_headers;
+        Vector<Header> m_vary_headers;
+        GBytes* m_body { nullptr };
+
+        i64 m_request_time { 0 };
+        i64 m_response_time { 0 };
+        i64 m_date_value { 0 };
+        i64 m_age_value { 0 };
+        i64 m_freshness_lifetime { 0 };
+        bool m_always_revalidate { false };
+
+        DeprecatedString m_etag;
+        DeprecatedString m_last_modified;
+
+        // Built on first use, so repeated hits hand LibWeb the same map without rebuilding it.
+        mutable Optional<HeaderMap> m_header_map;
+
+        friend class HttpCache;
+        u64 m_last_access { 0 };
+    };
+
+    enum class Tier {
+        Memory,
+        Disk,
+    };
+
+    struct Lookup {
+        NonnullRefPtr<Entry> entry;
+        Tier tier;
+    };
+
+    explicit HttpCache(Configuration);
+    ~HttpCache();
+
+    static i64 current_time();
+
+    Optional<Lookup> lookup(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers);
+    void store(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, u32 status_code, SoupMessageHeaders* response_headers, GBytes* body, i64 request_time, i64 response_time);
+    NonnullRefPtr<Entry> freshen(AK::URL const&, Entry const&, SoupMessageHeaders* not_modified_headers, i64 request_time, i64 response_time);
+    void invalidate(AK::URL const&);
+
+    void did_hit(Tier);
+    void did_revalidate() { ++m_statistics.revalidations; }
+    void did_miss() { ++m_statistics.misses; }
+
+    Statistics const& statistics() const { return m_statistics; }
+
+private:
+    static DeprecatedString key_for_url(AK::URL const&);
+    DeprecatedString path_for_key(DeprecatedString const& key) const;
+
+    RefPtr<Entry> load_from_disk(DeprecatedString const& key);
+    void write_to_disk(DeprecatedString const& key, Entry const&);
+    static void did_write_to_disk(GObject*, GAsyncResult*, gpointer);
+
+    void insert_into_memory(DeprecatedString const& key, NonnullRefPtr<Entry>);
+    void remove_from_memory(DeprecatedString const& key);
+    void evict_memory_if_needed();
+
+    Configuration m_configuration;
+    Statistics m_statistics;
+
+    HashMap<DeprecatedString, NonnullRefPtr<Entry>> m_memory_entries;
+    u64 m_access_counter { 0 };
+
+    bool m_has_scanned_disk { false };
+    u64 m_disk_size_estimate { 0 };
+    // Shared by every disk write, so their callbacks know not to touch us once we're gone.
+    GCancellable* m_disk_writes_cancellable { nullptr };
+};
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "InputLatency.h"
+#include <AK/BuiltinWrappers.h>
+#include <AK/Math.h>
+
+namespace Ladybird {
+
+size_t LatencyHistogram::bucket_for(u64 microseconds)
+{
+    if (microseconds < sub_buckets)
+        return microseconds;
+
+    size_t power = sizeof(u64) * 8 - 1 - count_leading_zeroes(microseconds);
+    size_t shift = power - sub_bucket_bits;
+    size_t bucket = (power - sub_bucket_bits + 1) * sub_buckets + ((microseconds >> shift) - sub_buckets);
+    return min(bucket, bucket_count - 1);
+}
+
+i64 LatencyHistogram::upper_bound_of(size_t bucket)
+{
+    if (bucket < sub_buckets)
+        return bucket;
+
+    size_t shift = bucket / sub_buckets - 1;
+    u64 lower = (sub_buckets + bucket % sub_buckets) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::record(i64 microseconds)
+{
+    if (microseconds < 0)
+        microseconds = 0;
+
+    ++m_buckets[bucket_for(microseconds)];
+    ++m_count;
+    m_max = max(m_max, microseconds);
+}
+
+void LatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+i64 LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+        return -1;
+
+    auto rank = static_cast<u64>(AK::ceil(clamp(percentile, 0.0, 100.0) / 100.0 * m_count));
+    rank = max<u64>(rank, 1);
+
+    u64 seen = 0;
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        seen += m_buckets[bucket];
+        if (seen >= rank)
+            return min(upper_bound_of(bucket), m_max);
+    }
+    return m_max;
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Types.h>
+
+namespace Ladybird {
+
+// Latencies in microseconds, kept in buckets that are 1/8th of a power of two wide, so percentiles are
+// never off by more than 12.5% however many samples there are, and recording one is a few shifts.
+class LatencyHistogram {
+public:
+    void record(i64 microseconds);
+    void reset();
+
+    u64 count() const { return m_count; }
+    i64 max() const { return m_max; }
+
+    // The upper bound of the bucket the percentile falls in, or -1 without any samples.
+    i64 percentile(double) const;
+
+private:
+    static constexpr size_t sub_buckets = 8;
+    static constexpr size_t sub_bucket_bits = 3;
+    // NOTE: Up to 2^27us, a little over two minutes. Anything slower than that ends up in the last bucket.
+    static constexpr size_t bucket_count = (27 - sub_bucket_bits + 1) * sub_buckets;
+
+    static size_t bucket_for(u64 microseconds);
+    static i64 upper_bound_of(size_t bucket);
+
+    Array<u64, bucket_count> m_buckets {};
+    u64 m_count { 0 };
+    i64 m_max { 0 };
+};
+
+// From when GDK saw an input event, to WebContent being done with it, to the next paint, to that frame being drawn.
+// Scrolls are only in the last two, as WebContent doesn't say when it's done with a viewport update.
+struct InputLatency {
+    LatencyHistogram handled;
+    LatencyHistogram painted;
+    LatencyHistogram presented;
+
+    void reset()
+    {
+        handled.reset();
+        painted.reset();
+        presented.reset();
+    }
+};
+
+}
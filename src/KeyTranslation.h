@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <Kernel/API/KeyCode.h>
+
+namespace Ladybird {
+
+struct KeyvalMapping {
+    unsigned gdk_key;
+    KeyCode serenity_key;
+};
+
+// Every keyval we translate, in no particular order. For checking (and timing) the lookup tables against a plain scan.
+ReadonlySpan<KeyvalMapping> keyval_mappings();
+
+KeyCode translate_keyval(unsigned int keyval);
+
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "MappedFileRequest.h"
+#include <AK/HashMap.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/System.h>
+#include <gio/gio.h>
+#include <sys/mman.h>
+
+namespace Ladybird {
+
+// Sniffing only ever looks at the start of a file.
+static constexpr size_t MIME_SNIFF_SIZE = 4 * KiB;
+static constexpr size_t MAX_CACHED_MIME_TYPES = 1024;
+// Past this, ask the kernel to start reading the rest of the file in while LibWeb is busy with the beginning.
+static constexpr size_t READAHEAD_THRESHOLD = 1 * MiB;
+
+struct CachedMimeType {
+    i64 modification_time { 0 };
+    i64 modification_time_nsec { 0 };
+    off_t size { 0 };
+    DeprecatedString mime_type;
+};
+
+// NOTE: Keyed on the path, and only trusted while the file looks unchanged. Pages tend to load the same few local files over and over.
+static HashMap<DeprecatedString, CachedMimeType> s_mime_types;
+
+static DeprecatedString sniff_mime_type(DeprecatedString const& path, struct stat const& st, ReadonlyBytes contents)
+{
+    if (auto cached = s_mime_types.get(path); cached.has_value()) {
+        if (cached->modification_time == st.st_mtim.tv_sec && cached->modification_time_nsec == st.st_mtim.tv_nsec && cached->size == st.st_size)
+            return cached->mime_type;
+    }
+
+    gboolean is_uncertain = FALSE;
+    auto sniff_size = min(contents.size(), MIME_SNIFF_SIZE);
+    g_autofree char* content_type = g_content_type_guess(path.characters(), sniff_size ? contents.data() : nullptr, sniff_size, &is_uncertain);
+    g_autofree char* mime_type = content_type ? g_content_type_get_mime_type(content_type) : nullptr;
+
+    DeprecatedString result = mime_type ? mime_type : "application/octet-stream";
+
+    if (s_mime_types.size() >= MAX_CACHED_MIME_TYPES)
+        s_mime_types.clear();
+    s_mime_types.set(path, { st.st_mtim.tv_sec, st.st_mtim.tv_nsec, st.st_size, result });
+    return result;
+}
+
+NonnullRefPtr<MappedFileRequest> MappedFileRequest::create(AK::URL const& url)
+{
+    auto request = adopt_ref(*new MappedFileRequest(url.serialize_path()));
+
+    // NOTE: Like cache hits, this must not finish before LibWeb has had a chance to hook up its callbacks.
+    Core::deferred_invoke([request] {
+        request->load();
+    });
+    return request;
+}
+
+MappedFileRequest::MappedFileRequest(DeprecatedString path)
+    : m_path(move(path))
+{
+}
+
+MappedFileRequest::~MappedFileRequest() = default;
+
+bool MappedFileRequest::stop()
+{
+    m_is_stopped = true;
+    return true;
+}
+
+void MappedFileRequest::load()
+{
+    if (m_is_stopped)
+        return;
+
+    auto fail = [&](auto const& error) {
+        dbgln("Unable to load {}: {}", m_path, error);
+        if (on_buffered_request_finish)
+            on_buffered_request_finish(false, 0, {}, {}, {});
+    };
+
+    auto st_or_error = Core::System::stat(m_path);
+    if (st_or_error.is_error()) {
+        fail(st_or_error.error());
+        return;
+    }
+    auto st = st_or_error.release_value();
+    if (!S_ISREG(st.st_mode)) {
+        fail("Not a regular file"sv);
+        return;
+    }
+
+    GError* error = nullptr;
+    GMappedFile* file = g_mapped_file_new(m_path.characters(), FALSE, &error);
+    if (!file) {
+        fail(error->message);
+        g_error_free(error);
+        return;
+    }
+    ScopeGuard unref_file = [&] { g_mapped_file_unref(file); };
+
+    ReadonlyBytes contents { reinterpret_cast<u8 const*>(g_mapped_file_get_contents(file)), g_mapped_file_get_length(file) };
+
+    // NOTE: The mapping is only faulted in as LibWeb copies it, so get a head start on what it's going to touch next.
+    if (contents.size() >= READAHEAD_THRESHOLD) {
+        auto* data = const_cast<u8*>(contents.data());
+        madvise(data, contents.size(), MADV_SEQUENTIAL);
+        madvise(data, contents.size(), MADV_WILLNEED);
+    }
+
+    HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> response_headers;
+    response_headers.set("Content-Type", sniff_mime_type(m_path, st, contents));
+    response_headers.set("Content-Length", DeprecatedString::number(contents.size()));
+
+    if (on_buffered_request_finish)
+        on_buffered_request_finish(true, contents.size(), response_headers, {}, contents);
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/URL.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+#include <glib.h>
+
+namespace Ladybird {
+
+// Loads a file:// URL by mapping the file, so its contents reach LibWeb without being read into a buffer of ours first.
+class MappedFileRequest : public Web::ResourceLoaderConnectorRequest {
+public:
+    static NonnullRefPtr<MappedFileRequest> create(AK::URL const&);
+
+    virtual ~MappedFileRequest() override;
+
+    virtual void set_should_buffer_all_input(bool) override { }
+    virtual bool stop() override;
+    virtual void stream_into(Stream&) override { }
+
+private:
+    explicit MappedFileRequest(DeprecatedString path);
+
+    void load();
+
+    DeprecatedString m_path;
+    bool m_is_stopped { false };
+};
+
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NetworkArchive.h"
+#include <AK/HashMap.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/System.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace Ladybird {
+
+// NOTE: WARC allows extension fields, these carry what replay needs beyond the response itself.
+static constexpr StringView METHOD_FIELD = "LibWebGTK-Request-Method"sv;
+static constexpr StringView DURATION_FIELD = "LibWebGTK-Duration"sv;
+
+static constexpr char INDEX_MAGIC[8] = { 'L', 'W', 'G', 'W', 'A', 'R', 'C', 'I' };
+static constexpr u32 INDEX_VERSION = 1;
+
+struct IndexHeader {
+    char magic[8];
+    u32 version;
+    u32 count;
+    // The size of the archive when it was indexed, anything recorded since means the index is stale.
+    u64 archive_size;
+};
+
+struct Head {
+    StringView start_line;
+    Vector<HttpCache::Header> fields;
+    size_t size { 0 };
+
+    Optional<DeprecatedString> field(StringView name) const
+    {
+        for (auto const& field : fields) {
+            if (field.name.equals_ignoring_ascii_case(name))
+                return field.value;
+        }
+        return {};
+    }
+};
+
+static Optional<Head> parse_head(StringView text)
+{
+    auto end = text.find("\r\n\r\n"sv);
+    if (!end.has_value())
+        return {};
+
+    auto lines = text.substring_view(0, *end).split_view("\r\n"sv);
+    if (lines.is_empty())
+        return {};
+
+    Head head;
+    head.start_line = lines[0];
+    head.size = *end + 4;
+
+    for (size_t i = 1; i < lines.size(); ++i) {
+        auto colon = lines[i].find(':');
+        if (!colon.has_value())
+            continue;
+        head.fields.append({ lines[i].substring_view(0, *colon).trim_whitespace(), lines[i].substring_view(*colon + 1).trim_whitespace() });
+    }
+
+    return head;
+}
+
+static bool is_archived_header(StringView name)
+{
+    // Bodies are archived after the content decoder has been at them, so anything describing the encoded body is wrong by then.
+    return !name.is_one_of_ignoring_ascii_case("content-encoding"sv, "content-length"sv, "transfer-encoding"sv);
+}
+
+NetworkArchive::NetworkArchive(Mode mode)
+    : m_mode(mode)
+{
+}
+
+ErrorOr<NonnullOwnPtr<NetworkArchive>> NetworkArchive::open_for_recording(DeprecatedString const& path)
+{
+    auto archive = TRY(adopt_nonnull_own_or_enomem(new (nothrow) NetworkArchive(Mode::Record)));
+
+    // NOTE: Appending lets several recordings (or WebContent processes) add to the same archive.
+    archive->m_file = TRY(Core::File::open(path, Core::File::OpenMode::Write | Core::File::OpenMode::Append));
+    return archive;
+}
+
+ErrorOr<NonnullOwnPtr<NetworkArchive>> NetworkArchive::open_for_replay(DeprecatedString const& path)
+{
+    auto archive = TRY(adopt_nonnull_own_or_enomem(new (nothrow) NetworkArchive(Mode::Replay)));
+    archive->m_archive = TRY(Core::MappedFile::map(path));
+    archive->load_or_build_index(DeprecatedString::formatted("{}.idx", path));
+    return archive;
+}
+
+DeprecatedString NetworkArchive::key_for(StringView method, StringView url)
+{
+    return DeprecatedString::formatted("{} {}", method, url);
+}
+
+u64 NetworkArchive::hash_key(StringView key)
+{
+    // NOTE: FNV-1a, as the index outlives the process and so can't use a seeded hash.
+    u64 hash = 0xcbf29ce484222325;
+    for (auto byte : key.bytes()) {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+ErrorOr<void> NetworkArchive::record(DeprecatedString const& method, AK::URL const& url, u32 status_code, SoupMessageHeaders* response_headers, ReadonlyBytes body, i64 duration)
+{
+    VERIFY(is_recording());
+
+    StringBuilder http_head;
+    auto const* reason = soup_status_get_phrase(status_code);
+    TRY(http_head.try_appendff("HTTP/1.1 {} {}\r\n", status_code, reason ? reason : ""));
+
+    SoupMessageHeadersIter iter;
+    char const *c_name, *c_value;
+    soup_message_headers_iter_init(&iter, response_headers);
+    while (soup_message_headers_iter_next(&iter, &c_name, &c_value)) {
+        StringView name { c_name, strlen(c_name) };
+        if (is_archived_header(name))
+            TRY(http_head.try_appendff("{}: {}\r\n", name, c_value));
+    }
+    TRY(http_head.try_appendff("Content-Length: {}\r\n\r\n", body.size()));
+
+    auto* now = g_date_time_new_now_utc();
+    auto* date = g_date_time_format_iso8601(now);
+    auto* record_id = g_uuid_string_random();
+
+    StringBuilder record;
+    TRY(record.try_append("WARC/1.1\r\n"sv));
+    TRY(record.try_append("WARC-Type: response\r\n"sv));
+    TRY(record.try_appendff("WARC-Record-ID: <urn:uuid:{}>\r\n", record_id));
+    TRY(record.try_appendff("WARC-Date: {}\r\n", date));
+    TRY(record.try_appendff("WARC-Target-URI: {}\r\n", url.serialize(AK::URL::ExcludeFragment::Yes)));
+    TRY(record.try_append("Content-Type: application/http;msgtype=response\r\n"sv));
+    TRY(record.try_appendff("{}: {}\r\n", METHOD_FIELD, method));
+    TRY(record.try_appendff("{}: {}\r\n", DURATION_FIELD, duration));
+    TRY(record.try_appendff("Content-Length: {}\r\n\r\n", http_head.length() + body.size()));
+    TRY(record.try_append(http_head.string_view()));
+    TRY(record.try_append(StringView { body }));
+    TRY(record.try_append("\r\n\r\n"sv));
+
+    g_free(record_id);
+    g_free(date);
+    g_date_time_unref(now);
+
+    // NOTE: One write per record, so records from concurrent writers don't interleave.
+    TRY(m_file->write_until_depleted(record.string_view().bytes()));
+    return {};
+}
+
+Optional<NetworkArchive::Record> NetworkArchive::read_record(size_t offset, size_t* next_offset) const
+{
+    auto data = m_archive->bytes();
+    if (offset >= data.size())
+        return {};
+
+    StringView text { data.slice(offset) };
+    auto warc = parse_head(text);
+    if (!warc.has_value() || !warc->start_line.starts_with("WARC/"sv))
+        return {};
+
+    auto block_size = warc->field("Content-Length"sv).value_or({}).to_uint<u64>();
+    if (!block_size.has_value() || warc->size + *block_size > text.length())
+        return {};
+
+    if (next_offset)
+        *next_offset = offset + warc->size + *block_size + 4;
+
+    // Other kinds of record (warcinfo, request, ...) are skipped over.
+    if (!warc->field("WARC-Type"sv).value_or({}).equals_ignoring_ascii_case("response"sv))
+        return {};
+
+    auto block = text.substring_view(warc->size, *block_size);
+    auto http = parse_head(block);
+    if (!http.has_value())
+        return {};
+
+    auto status_line = http->start_line.split_view(' ');
+    if (status_line.size() < 2 || !status_line[0].starts_with("HTTP/"sv))
+        return {};
+    auto status_code = status_line[1].to_uint<u32>();
+    if (!status_code.has_value())
+        return {};
+
+    Record record;
+    record.method = warc->field(METHOD_FIELD).value_or("GET");
+    record.url = warc->field("WARC-Target-URI"sv).value_or({});
+    record.status_code = *status_code;
+    record.body = data.slice(offset + warc->size + http->size, *block_size - http->size);
+    record.duration = warc->field(DURATION_FIELD).value_or({}).to_int<i64>().value_or(0);
+
+    record.response_headers.ensure_capacity(http->fields.size());
+    for (auto& field : http->fields) {
+        if (!field.name.equals_ignoring_ascii_case("content-length"sv))
+            record.response_headers.append(move(field));
+    }
+
+    return record;
+}
+
+Optional<NetworkArchive::Record> NetworkArchive::find(DeprecatedString const& method, AK::URL const& url) const
+{
+    VERIFY(is_replaying());
+
+    auto url_string = url.serialize(AK::URL::ExcludeFragment::Yes);
+    auto hash = hash_key(key_for(method, url_string));
+
+    size_t low = 0;
+    size_t high = m_index.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_index[middle].key_hash < hash)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (; low < m_index.size() && m_index[low].key_hash == hash; ++low) {
+        auto record = read_record(m_index[low].offset);
+        if (record.has_value() && record->method == method && record->url == url_string)
+            return record;
+    }
+
+    return {};
+}
+
+void NetworkArchive::load_or_build_index(DeprecatedString const& index_path)
+{
+    if (auto index_or_error = Core::MappedFile::map(index_path); !index_or_error.is_error()) {
+        auto index = index_or_error.release_value();
+        auto bytes = index->bytes();
+
+        if (bytes.size() >= sizeof(IndexHeader)) {
+            auto const& header = *reinterpret_cast<IndexHeader const*>(bytes.data());
+            if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0
+                && header.version == INDEX_VERSION
+                && header.archive_size == m_archive->size()
+                && bytes.size() == sizeof(IndexHeader) + header.count * sizeof(IndexEntry)) {
+                m_index = { reinterpret_cast<IndexEntry const*>(bytes.data() + sizeof(IndexHeader)), header.count };
+                m_index_file = move(index);
+                return;
+            }
+        }
+    }
+
+    // NOTE: When a request was recorded more than once, the latest response wins.
+    HashMap<u64, u64> latest_offsets;
+    size_t offset = 0;
+    while (offset < m_archive->size()) {
+        size_t next_offset = 0;
+        auto record = read_record(offset, &next_offset);
+        if (next_offset <= offset) {
+            dbgln("Stopped indexing network archive at malformed record at offset {}", offset);
+            break;
+        }
+        if (record.has_value())
+            latest_offsets.set(hash_key(key_for(record->method, record->url)), offset);
+        offset = next_offset;
+    }
+
+    m_built_index.ensure_capacity(latest_offsets.size());
+    for (auto const& it : latest_offsets)
+        m_built_index.unchecked_append({ it.key, it.value });
+    quick_sort(m_built_index, [](auto const& a, auto const& b) { return a.key_hash < b.key_hash; });
+    m_index = m_built_index.span();
+
+    if (auto result = write_index(index_path, m_index); result.is_error())
+        dbgln("Unable to write network archive index to {}: {}", index_path, result.error());
+}
+
+ErrorOr<void> NetworkArchive::write_index(DeprecatedString const& index_path, ReadonlySpan<IndexEntry> entries) const
+{
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.count = static_cast<u32>(entries.size());
+    header.archive_size = m_archive->size();
+
+    // NOTE: Replace the index in one go, another process may be replaying from the same archive.
+    auto temporary_path = DeprecatedString::formatted("{}.{}", index_path, getpid());
+    auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    TRY(file->write_until_depleted({ reinterpret_cast<u8 const*>(&header), sizeof(header) }));
+    TRY(file->write_until_depleted({ reinterpret_cast<u8 const*>(entries.data()), entries.size() * sizeof(IndexEntry) }));
+    file->close();
+
+    TRY(Core::System::rename(temporary_path, index_path));
+    return {};
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "HttpCache.h"
+#include <AK/DeprecatedString.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <libsoup/soup.h>
+
+namespace Ladybird {
+
+// Every response we load, written out as WARC/1.1 "response" records so that page loads can be replayed offline.
+// Replay looks records up through an index kept next to the archive ("<archive>.idx"), which is rebuilt whenever the archive has grown since.
+class NetworkArchive {
+public:
+    enum class Mode {
+        Record,
+        Replay,
+    };
+
+    struct Record {
+        DeprecatedString method;
+        DeprecatedString url;
+        u32 status_code { 0 };
+        Vector<HttpCache::Header> response_headers;
+        // NOTE: Points into the mapped archive, which lives as long as the NetworkArchive does.
+        ReadonlyBytes body;
+        // How long the response originally took to arrive, in microseconds.
+        i64 duration { 0 };
+    };
+
+    static ErrorOr<NonnullOwnPtr<NetworkArchive>> open_for_recording(DeprecatedString const& path);
+    static ErrorOr<NonnullOwnPtr<NetworkArchive>> open_for_replay(DeprecatedString const& path);
+
+    Mode mode() const { return m_mode; }
+    bool is_recording() const { return m_mode == Mode::Record; }
+    bool is_replaying() const { return m_mode == Mode::Replay; }
+
+    ErrorOr<void> record(DeprecatedString const& method, AK::URL const&, u32 status_code, SoupMessageHeaders* response_headers, ReadonlyBytes body, i64 duration);
+    Optional<Record> find(DeprecatedString const& method, AK::URL const&) const;
+
+private:
+    struct IndexEntry {
+        u64 key_hash { 0 };
+        u64 offset { 0 };
+    };
+
+    explicit NetworkArchive(Mode);
+
+    static DeprecatedString key_for(StringView method, StringView url);
+    static u64 hash_key(StringView key);
+
+    Optional<Record> read_record(size_t offset, size_t* next_offset = nullptr) const;
+    void load_or_build_index(DeprecatedString const& index_path);
+    ErrorOr<void> write_index(DeprecatedString const& index_path, ReadonlySpan<IndexEntry>) const;
+
+    Mode m_mode;
+
+    // Record mode.
+    OwnPtr<Core::File> m_file;
+
+    // Replay mode.
+    RefPtr<Core::MappedFile> m_archive;
+    RefPtr<Core::MappedFile> m_index_file;
+    Vector<IndexEntry> m_built_index;
+    ReadonlySpan<IndexEntry> m_index;
+};
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NetworkConditions.h"
+#include <glib.h>
+#include <stdlib.h>
+
+namespace Ladybird {
+
+// NOTE: Allow some burst, otherwise a link any slower than our read chunks would stall on every single read.
+static constexpr double BURST_SECONDS = 0.1;
+
+Optional<NetworkConditions> NetworkConditions::parse(StringView value)
+{
+    NetworkConditions conditions;
+
+    for (auto field : value.split_view(',')) {
+        auto equals = field.find('=');
+        if (!equals.has_value())
+            return {};
+
+        auto name = field.substring_view(0, *equals).trim_whitespace();
+        auto argument = field.substring_view(*equals + 1).trim_whitespace();
+
+        if (name == "failure"sv) {
+            // NOTE: StringView has no floating point parsing, so go through strtod() on a terminated copy.
+            DeprecatedString terminated { argument };
+            char* end = nullptr;
+            auto rate = strtod(terminated.characters(), &end);
+            if (terminated.is_empty() || *end || rate < 0 || rate > 1)
+                return {};
+            conditions.failure_rate = rate;
+            continue;
+        }
+
+        auto number = argument.to_uint<u64>();
+        if (!number.has_value())
+            return {};
+
+        if (name == "latency"sv)
+            conditions.latency_ms = static_cast<u32>(*number);
+        else if (name == "download"sv)
+            conditions.download_throughput = *number;
+        else if (name == "upload"sv)
+            conditions.upload_throughput = *number;
+        else
+            return {};
+    }
+
+    return conditions;
+}
+
+DeprecatedString NetworkConditions::to_deprecated_string() const
+{
+    return DeprecatedString::formatted("latency={},download={},upload={},failure={}", latency_ms, download_throughput, upload_throughput, failure_rate);
+}
+
+void TokenBucket::set_rate(u64 bytes_per_second)
+{
+    m_rate = bytes_per_second;
+    m_tokens = static_cast<double>(bytes_per_second) * BURST_SECONDS;
+    m_last_refill = g_get_monotonic_time();
+}
+
+i64 TokenBucket::consume(u64 bytes)
+{
+    if (!m_rate)
+        return 0;
+
+    auto now = g_get_monotonic_time();
+    auto burst = static_cast<double>(m_rate) * BURST_SECONDS;
+    m_tokens = min(burst, m_tokens + static_cast<double>(now - m_last_refill) * static_cast<double>(m_rate) / 1'000'000.0);
+    m_last_refill = now;
+
+    // NOTE: The bucket goes into debt rather than making anyone wait their turn, which evens out across everything sharing the link.
+    m_tokens -= static_cast<double>(bytes);
+    if (m_tokens >= 0)
+        return 0;
+    return static_cast<i64>(-m_tokens * 1'000'000.0 / static_cast<double>(m_rate));
+}
+
+}
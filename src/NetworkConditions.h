@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace Ladybird {
+
+// An emulated network link, for seeing how pages load over poor connections without needing one.
+struct NetworkConditions {
+    // Added to every request before it is sent.
+    u32 latency_ms { 0 };
+    // In bytes per second, where 0 means unlimited.
+    u64 download_throughput { 0 };
+    u64 upload_throughput { 0 };
+    // The chance, between 0 and 1, that a request fails as though the connection had dropped.
+    double failure_rate { 0 };
+
+    bool is_enabled() const { return latency_ms || download_throughput || upload_throughput || failure_rate > 0; }
+
+    // Parses the form used in the environment, e.g. "latency=150,download=200000,upload=100000,failure=0.01".
+    static Optional<NetworkConditions> parse(StringView);
+    DeprecatedString to_deprecated_string() const;
+};
+
+// Throughput limit shared by every request going over the same emulated link.
+class TokenBucket {
+public:
+    void set_rate(u64 bytes_per_second);
+
+    // Takes the bytes out of the bucket, and returns how many microseconds to wait before they would have made it across.
+    i64 consume(u64 bytes);
+
+private:
+    u64 m_rate { 0 };
+    double m_tokens { 0 };
+    i64 m_last_refill { 0 };
+};
+
+}
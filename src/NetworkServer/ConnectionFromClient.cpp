@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ConnectionFromClient.h"
+#include <LibCore/Proxy.h>
+
+namespace NetworkServer {
+
+static HashMap<int, RefPtr<ConnectionFromClient>> s_connections;
+
+ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> socket, int client_id)
+    : IPC::ConnectionFromClient<NetworkClientEndpoint, NetworkServerEndpoint>(*this, move(socket), client_id)
+{
+    s_connections.set(client_id, *this);
+}
+
+void ConnectionFromClient::die()
+{
+    // NOTE: Requests can't be cancelled yet, so let the ones in flight finish into the void. Their callbacks only hold a weak
+    //       pointer to us, wherever the request manager has them queued or coalesced.
+    m_requests.clear();
+
+    s_connections.remove(client_id());
+    if (on_disconnect)
+        on_disconnect();
+}
+
+void ConnectionFromClient::start_request(i32 request_id, DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, Core::AnonymousBuffer const& request_body)
+{
+    VERIFY(m_request_manager);
+
+    // NOTE: Local files and custom schemes are the client's to load. Besides, whatever the request manager returns for
+    //       those isn't a RequestManagerSoup::Request, which is what we take everything we hand out below to be.
+    if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv)) {
+        dbgln("NetworkServer: Refusing to load {}", url);
+        async_request_finished(request_id, false, {}, {}, {}, {}, false);
+        return;
+    }
+
+    ReadonlyBytes body;
+    if (request_body.is_valid())
+        body = request_body.bytes();
+
+    auto request = m_request_manager->start_request(method, url, request_headers, body, {});
+    if (!request) {
+        async_request_finished(request_id, false, {}, {}, {}, {}, false);
+        return;
+    }
+
+    request->on_buffered_request_finish = [weak_this = make_weak_ptr<ConnectionFromClient>(), request_id](bool success, auto, auto& response_headers, auto status_code, ReadonlyBytes payload) {
+        if (weak_this)
+            weak_this->did_finish_request(request_id, success, status_code, response_headers, payload);
+    };
+    static_cast<RequestManagerSoup::Request&>(*request).on_upload_progress = [weak_this = make_weak_ptr<ConnectionFromClient>(), request_id](u64 bytes_sent, u64 total_bytes) {
+        if (weak_this)
+            weak_this->async_request_upload_progress(request_id, bytes_sent, total_bytes);
+    };
+
+    m_requests.set(request_id, request.release_nonnull());
+}
+
+void ConnectionFromClient::prefetch_dns(URL const& url)
+{
+    m_request_manager->prefetch_dns(url);
+}
+
+void ConnectionFromClient::preconnect(URL const& url)
+{
+    m_request_manager->preconnect(url);
+}
+
+void ConnectionFromClient::prefetch(URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    m_request_manager->prefetch(url, request_headers);
+}
+
+void ConnectionFromClient::did_finish_request(i32 request_id, bool success, Optional<u32> status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, ReadonlyBytes body)
+{
+    // NOTE: Keep the request alive until we're out of its callback.
+    auto request = m_requests.take(request_id);
+
+    Ladybird::RequestTiming timing;
+    bool coalesced = false;
+    if (request.has_value()) {
+        auto& soup_request = static_cast<RequestManagerSoup::Request&>(**request);
+        timing = soup_request.timing().value_or({});
+        coalesced = soup_request.was_coalesced();
+    }
+
+    // Bodies go over shared memory, so a large response is one copy here rather than a trip through the socket.
+    Core::AnonymousBuffer buffer;
+    if (!body.is_empty()) {
+        auto buffer_or_error = Core::AnonymousBuffer::create_with_size(body.size());
+        if (buffer_or_error.is_error()) {
+            dbgln("Unable to allocate {} bytes for response body: {}", body.size(), buffer_or_error.error());
+            async_request_finished(request_id, false, {}, {}, {}, timing, coalesced);
+            return;
+        }
+        buffer = buffer_or_error.release_value();
+        body.copy_to(Bytes { buffer.data<u8>(), buffer.size() });
+    }
+
+    async_request_finished(request_id, success, status_code, response_headers, buffer, timing, coalesced);
+}
+
+Messages::NetworkServer::GetHttpCacheStatisticsResponse ConnectionFromClient::get_http_cache_statistics()
+{
+    auto statistics = m_request_manager->http_cache_statistics();
+    if (!statistics.has_value())
+        return { false, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    return { true, statistics->memory_hits, statistics->disk_hits, statistics->revalidations, statistics->misses, statistics->stores, statistics->evictions, statistics->memory_size, statistics->disk_size };
+}
+
+Messages::NetworkServer::GetPreloadStatisticsResponse ConnectionFromClient::get_preload_statistics()
+{
+    auto statistics = m_request_manager->preload_statistics();
+    return { statistics.issued, statistics.used, statistics.wasted };
+}
+
+Messages::NetworkServer::GetTlsStatisticsResponse ConnectionFromClient::get_tls_statistics()
+{
+    auto statistics = m_request_manager->tls_statistics();
+    return { statistics.handshakes, statistics.resumption_attempts, statistics.resumed, statistics.handshake_time };
+}
+
+void ConnectionFromClient::set_network_conditions(u32 latency_ms, u64 download_throughput, u64 upload_throughput, double failure_rate)
+{
+    m_request_manager->set_network_conditions({
+        .latency_ms = latency_ms,
+        .download_throughput = download_throughput,
+        .upload_throughput = upload_throughput,
+        .failure_rate = failure_rate,
+    });
+}
+
+}
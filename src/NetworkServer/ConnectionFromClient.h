@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "../RequestManagerSoup.h"
+#include <AK/HashMap.h>
+#include <LibIPC/ConnectionFromClient.h>
+#include <NetworkServer/NetworkClientEndpoint.h>
+#include <NetworkServer/NetworkServerEndpoint.h>
+
+namespace NetworkServer {
+
+class ConnectionFromClient final
+    : public IPC::ConnectionFromClient<NetworkClientEndpoint, NetworkServerEndpoint> {
+    C_OBJECT(ConnectionFromClient);
+
+public:
+    virtual ~ConnectionFromClient() override = default;
+
+    virtual void die() override;
+
+    void set_request_manager(NonnullRefPtr<RequestManagerSoup> request_manager) { m_request_manager = move(request_manager); }
+
+    Function<void()> on_disconnect;
+
+private:
+    explicit ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket>, int client_id);
+
+    virtual void start_request(i32 request_id, DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, Core::AnonymousBuffer const& request_body) override;
+    virtual void prefetch_dns(URL const&) override;
+    virtual void preconnect(URL const&) override;
+    virtual void prefetch(URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers) override;
+    virtual Messages::NetworkServer::GetHttpCacheStatisticsResponse get_http_cache_statistics() override;
+    virtual Messages::NetworkServer::GetPreloadStatisticsResponse get_preload_statistics() override;
+    virtual Messages::NetworkServer::GetTlsStatisticsResponse get_tls_statistics() override;
+    virtual void set_network_conditions(u32 latency_ms, u64 download_throughput, u64 upload_throughput, double failure_rate) override;
+
+    void did_finish_request(i32 request_id, bool success, Optional<u32> status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, ReadonlyBytes body);
+
+    RefPtr<RequestManagerSoup> m_request_manager;
+    HashMap<i32, NonnullRefPtr<Web::ResourceLoaderConnectorRequest>> m_requests;
+};
+
+}
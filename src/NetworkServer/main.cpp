@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "../EventLoopImplementationGLib.h"
+#include "../NetworkSettings.h"
+#include "../RequestManagerSoup.h"
+#include "ConnectionFromClient.h"
+#include <LibCore/EventLoop.h>
+#include <LibIPC/MultiServer.h>
+#include <LibMain/Main.h>
+#include <glibmm/init.h>
+
+// One SoupSession (and so one connection pool, DNS cache, TLS session cache and HTTP cache) for every WebContent process of an application.
+ErrorOr<int> serenity_main(Main::Arguments)
+{
+    Glib::init();
+
+    Core::EventLoopManager::install(*new Ladybird::EventLoopManagerGLib);
+    Core::EventLoop event_loop;
+
+    auto settings = Ladybird::NetworkSettings::from_environment();
+    // NOTE: Nothing else runs on this process's main thread, so it may as well drive the session itself.
+    settings.use_network_thread = false;
+    auto request_manager = RequestManagerSoup::create(settings);
+
+    // NOTE: Timings are sent along with each response and kept by the WebContent process that asked, so they're attributed to the right view.
+    request_manager->set_records_timings(false);
+
+    auto server = TRY(IPC::MultiServer<NetworkServer::ConnectionFromClient>::try_create());
+    u64 connection_count { 0 };
+
+    server->on_new_client = [&](auto& client) {
+        client.set_request_manager(request_manager);
+        ++connection_count;
+
+        // NOTE: The embedding application keeps a connection open for as long as it's running, so this only happens once it has gone away.
+        client.on_disconnect = [&]() {
+            if (--connection_count == 0)
+                event_loop.quit(0);
+        };
+    };
+
+    return event_loop.exec();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NetworkServerClient.h"
+#include <AK/ScopeGuard.h>
+#include <LibCore/SocketAddress.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace Ladybird {
+
+ErrorOr<NonnullRefPtr<NetworkServerClient>> NetworkServerClient::try_create(NonnullOwnPtr<Core::LocalSocket> socket)
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) NetworkServerClient(move(socket)));
+}
+
+ErrorOr<NonnullRefPtr<NetworkServerClient>> NetworkServerClient::connect(StringView socket_path)
+{
+    auto socket = TRY(Core::LocalSocket::connect(socket_path));
+    TRY(socket->set_blocking(true));
+    return try_create(move(socket));
+}
+
+NetworkServerClient::NetworkServerClient(NonnullOwnPtr<Core::LocalSocket> socket)
+    : IPC::ConnectionToServer<NetworkClientEndpoint, NetworkServerEndpoint>(*this, move(socket))
+{
+}
+
+void NetworkServerClient::die()
+{
+    if (on_death)
+        on_death();
+}
+
+void NetworkServerClient::request_finished(i32 request_id, bool success, Optional<u32> const& status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Core::AnonymousBuffer const& body, Ladybird::RequestTiming const& timing, bool coalesced)
+{
+    if (on_request_finished)
+        on_request_finished(request_id, success, status_code, response_headers, body, timing, coalesced);
+}
+
+void NetworkServerClient::request_upload_progress(i32 request_id, u64 bytes_sent, u64 total_bytes)
+{
+    if (on_request_upload_progress)
+        on_request_upload_progress(request_id, bytes_sent, total_bytes);
+}
+
+ErrorOr<DeprecatedString> NetworkServerClient::launch_server(ReadonlySpan<String> candidate_server_paths)
+{
+    // NOTE: Each application gets its own server, as they may well disagree about cache locations and connection limits.
+    auto runtime_directory = TRY(Core::StandardPaths::runtime_directory());
+    auto socket_path = DeprecatedString::formatted("{}/LibWebGTK-NetworkServer.{}.socket", runtime_directory, getpid());
+
+    // A leftover socket from an earlier process with the same pid would make bind() fail.
+    (void)Core::System::unlink(socket_path);
+
+    auto socket_fd = TRY(Core::System::socket(AF_LOCAL, SOCK_STREAM, 0));
+    ScopeGuard close_socket = [&] {
+        MUST(Core::System::close(socket_fd));
+    };
+
+    auto socket_address = Core::SocketAddress::local(socket_path);
+    auto socket_address_un = socket_address.to_sockaddr_un().release_value();
+    TRY(Core::System::bind(socket_fd, reinterpret_cast<sockaddr*>(&socket_address_un), sizeof(socket_address_un)));
+    TRY(Core::System::listen(socket_fd, 16));
+
+    // Don't do anything between fork() and exec() that might allocate.
+    auto takeover_string = DeprecatedString::formatted("NetworkServer:{}", socket_fd);
+    Vector<StringView> server_paths;
+    for (auto const& path : candidate_server_paths)
+        TRY(server_paths.try_append(path.bytes_as_string_view()));
+
+    // NOTE: The server exits by itself once its last client is gone, which may well be before we do. Start it from a
+    //       short-lived intermediate process instead of as our own child, so it's adopted (and reaped) by init.
+    auto intermediate_pid = TRY(Core::System::fork());
+    if (intermediate_pid == 0) {
+        auto server_pid = fork();
+        if (server_pid != 0)
+            _exit(server_pid < 0 ? 1 : 0);
+
+        MUST(Core::System::setenv("SOCKET_TAKEOVER"sv, takeover_string, true));
+
+        ErrorOr<void> result;
+        for (auto const& server_path : server_paths) {
+            ReadonlySpan<StringView> arguments { &server_path, 1 };
+            result = Core::System::exec(server_path, arguments, Core::System::SearchInPath::No);
+            if (!result.is_error())
+                break;
+        }
+
+        warnln("Could not launch any of {}: {}", candidate_server_paths, result.error());
+        _exit(1);
+    }
+
+    auto wait_result = TRY(Core::System::waitpid(intermediate_pid, 0));
+    if (!WIFEXITED(wait_result.status) || WEXITSTATUS(wait_result.status) != 0)
+        return Error::from_string_literal("Unable to fork the NetworkServer");
+
+    return socket_path;
+}
+
+}
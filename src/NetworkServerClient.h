@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/String.h>
+#include <LibIPC/ConnectionToServer.h>
+#include <NetworkServer/NetworkClientEndpoint.h>
+#include <NetworkServer/NetworkServerEndpoint.h>
+
+namespace Ladybird {
+
+class NetworkServerClient final
+    : public IPC::ConnectionToServer<NetworkClientEndpoint, NetworkServerEndpoint>
+    , public NetworkClientEndpoint {
+public:
+    static ErrorOr<NonnullRefPtr<NetworkServerClient>> try_create(NonnullOwnPtr<Core::LocalSocket>);
+    static ErrorOr<NonnullRefPtr<NetworkServerClient>> connect(StringView socket_path);
+
+    // Starts a NetworkServer for this application, and returns the path of the socket WebContent processes should connect to.
+    static ErrorOr<DeprecatedString> launch_server(ReadonlySpan<String> candidate_server_paths);
+
+    virtual ~NetworkServerClient() override = default;
+
+    Function<void(i32 request_id, bool success, Optional<u32> status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Core::AnonymousBuffer const& body, Ladybird::RequestTiming const& timing, bool coalesced)> on_request_finished;
+    Function<void(i32 request_id, u64 bytes_sent, u64 total_bytes)> on_request_upload_progress;
+    Function<void()> on_death;
+
+private:
+    explicit NetworkServerClient(NonnullOwnPtr<Core::LocalSocket>);
+
+    virtual void die() override;
+
+    virtual void request_finished(i32 request_id, bool success, Optional<u32> const& status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Core::AnonymousBuffer const& body, Ladybird::RequestTiming const& timing, bool coalesced) override;
+    virtual void request_upload_progress(i32 request_id, u64 bytes_sent, u64 total_bytes) override;
+};
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NetworkSettings.h"
+#include <AK/StringView.h>
+#include <LibCore/StandardPaths.h>
+#include <stdlib.h>
+
+namespace Ladybird {
+
+static Optional<StringView> environment_value(char const* name)
+{
+    auto const* value = getenv(name);
+    if (!value || !*value)
+        return {};
+    return StringView { value, strlen(value) };
+}
+
+static bool boolean_from_environment(char const* name, bool fallback)
+{
+    auto value = environment_value(name);
+    if (!value.has_value())
+        return fallback;
+    return !value->is_one_of("0"sv, "no"sv, "false"sv, "off"sv);
+}
+
+static u64 size_from_environment(char const* name, u64 fallback)
+{
+    auto value = environment_value(name);
+    if (!value.has_value())
+        return fallback;
+
+    auto size = value->to_uint<u64>();
+    if (!size.has_value()) {
+        dbgln("Ignoring invalid value '{}' for {}", *value, name);
+        return fallback;
+    }
+    return *size;
+}
+
+NetworkSettings NetworkSettings::from_environment()
+{
+    NetworkSettings settings;
+
+    settings.use_network_server = boolean_from_environment(NETWORK_SERVER_ENABLED_ENV, settings.use_network_server);
+    settings.use_network_thread = boolean_from_environment(NETWORK_THREAD_ENV, settings.use_network_thread);
+    settings.http_cache_enabled = boolean_from_environment(HTTP_CACHE_ENABLED_ENV, settings.http_cache_enabled);
+    settings.http_cache_memory_size = size_from_environment(HTTP_CACHE_MEMORY_SIZE_ENV, settings.http_cache_memory_size);
+    settings.http_cache_disk_size = size_from_environment(HTTP_CACHE_DISK_SIZE_ENV, settings.http_cache_disk_size);
+    settings.preload_scanner_enabled = boolean_from_environment(PRELOAD_SCANNER_ENV, settings.preload_scanner_enabled);
+
+    settings.max_connections = max(1u, static_cast<u32>(size_from_environment(MAX_CONNECTIONS_ENV, settings.max_connections)));
+    settings.max_connections_per_host = max(1u, static_cast<u32>(size_from_environment(MAX_CONNECTIONS_PER_HOST_ENV, settings.max_connections_per_host)));
+
+    if (auto conditions = environment_value(NETWORK_CONDITIONS_ENV); conditions.has_value()) {
+        if (auto parsed = NetworkConditions::parse(*conditions); parsed.has_value())
+            settings.network_conditions = *parsed;
+        else
+            dbgln("Ignoring invalid value '{}' for {}", *conditions, NETWORK_CONDITIONS_ENV);
+    }
+
+    if (auto path = environment_value(NETWORK_ARCHIVE_ENV); path.has_value()) {
+        auto mode = environment_value(NETWORK_ARCHIVE_MODE_ENV).value_or("replay"sv);
+        if (mode.equals_ignoring_ascii_case("record"sv))
+            settings.network_archive_mode = NetworkArchiveMode::Record;
+        else if (mode.equals_ignoring_ascii_case("replay"sv))
+            settings.network_archive_mode = NetworkArchiveMode::Replay;
+        else
+            dbgln("Ignoring invalid value '{}' for {}", mode, NETWORK_ARCHIVE_MODE_ENV);
+
+        settings.network_archive_path = *path;
+        settings.network_archive_original_latency = !environment_value(NETWORK_ARCHIVE_LATENCY_ENV).value_or("original"sv).equals_ignoring_ascii_case("none"sv);
+    }
+
+    if (auto directory = environment_value(HTTP_CACHE_DIRECTORY_ENV); directory.has_value())
+        settings.http_cache_directory = *directory;
+    else
+        settings.http_cache_directory = DeprecatedString::formatted("{}/LibWebGTK/HttpCache", Core::StandardPaths::data_directory());
+
+    return settings;
+}
+
+}
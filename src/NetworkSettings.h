@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "NetworkConditions.h"
+#include <AK/DeprecatedString.h>
+#include <AK/Types.h>
+
+namespace Ladybird {
+
+// NOTE: WebContent processes are spawned by LibWebView, so we have no say over their command line.
+//       The embedding API passes network configuration down through the environment instead.
+static constexpr char const* HTTP_CACHE_ENABLED_ENV = "LIBWEB_GTK_HTTP_CACHE";
+static constexpr char const* HTTP_CACHE_DIRECTORY_ENV = "LIBWEB_GTK_HTTP_CACHE_DIR";
+static constexpr char const* HTTP_CACHE_MEMORY_SIZE_ENV = "LIBWEB_GTK_HTTP_CACHE_MEMORY_SIZE";
+static constexpr char const* HTTP_CACHE_DISK_SIZE_ENV = "LIBWEB_GTK_HTTP_CACHE_DISK_SIZE";
+static constexpr char const* NETWORK_SERVER_ENABLED_ENV = "LIBWEB_GTK_NETWORK_SERVER";
+static constexpr char const* MAX_CONNECTIONS_ENV = "LIBWEB_GTK_MAX_CONNECTIONS";
+static constexpr char const* MAX_CONNECTIONS_PER_HOST_ENV = "LIBWEB_GTK_MAX_CONNECTIONS_PER_HOST";
+static constexpr char const* NETWORK_ARCHIVE_ENV = "LIBWEB_GTK_NETWORK_ARCHIVE";
+static constexpr char const* NETWORK_ARCHIVE_MODE_ENV = "LIBWEB_GTK_NETWORK_ARCHIVE_MODE";
+static constexpr char const* NETWORK_ARCHIVE_LATENCY_ENV = "LIBWEB_GTK_NETWORK_ARCHIVE_LATENCY";
+static constexpr char const* NETWORK_CONDITIONS_ENV = "LIBWEB_GTK_NETWORK_CONDITIONS";
+static constexpr char const* NETWORK_THREAD_ENV = "LIBWEB_GTK_NETWORK_THREAD";
+static constexpr char const* PRELOAD_SCANNER_ENV = "LIBWEB_GTK_PRELOAD_SCANNER";
+
+enum class NetworkArchiveMode {
+    Off,
+    Record,
+    Replay,
+};
+
+struct NetworkSettings {
+    static NetworkSettings from_environment();
+
+    // Whether all WebContent processes of the application load through one shared NetworkServer process.
+    bool use_network_server { false };
+
+    // Whether RequestManagerSoup drives its SoupSession from a thread of its own, rather than the main thread that also runs JavaScript and layout.
+    bool use_network_thread { true };
+
+    bool http_cache_enabled { true };
+    DeprecatedString http_cache_directory;
+    u64 http_cache_memory_size { 32 * MiB };
+    u64 http_cache_disk_size { 256 * MiB };
+    // Whether documents are scanned for subresources to fetch into the cache ahead of LibWeb's parser.
+    bool preload_scanner_enabled { true };
+
+    // NOTE: These are applied to the SoupSession, where they can only be set at construction time.
+    u32 max_connections { 24 };
+    u32 max_connections_per_host { 6 };
+
+    // Recording writes every response to the archive, replaying serves every request from it and never touches the network.
+    NetworkArchiveMode network_archive_mode { NetworkArchiveMode::Off };
+    DeprecatedString network_archive_path;
+    // Whether replayed responses take as long to arrive as they did when recorded, or arrive straight away.
+    bool network_archive_original_latency { true };
+
+    NetworkConditions network_conditions;
+};
+
+}
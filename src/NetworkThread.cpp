@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NetworkThread.h"
+
+namespace Ladybird {
+
+NetworkThread::NetworkThread()
+{
+    g_mutex_init(&m_mutex);
+    g_cond_init(&m_condition);
+
+    m_context = g_main_context_new();
+    m_loop = g_main_loop_new(m_context, FALSE);
+    m_thread = g_thread_new("Network", thread_main, this);
+}
+
+NetworkThread::~NetworkThread()
+{
+    run([loop = m_loop] { g_main_loop_quit(loop); });
+    g_thread_join(m_thread);
+
+    g_main_loop_unref(m_loop);
+    g_main_context_unref(m_context);
+    g_cond_clear(&m_condition);
+    g_mutex_clear(&m_mutex);
+}
+
+gpointer NetworkThread::thread_main(gpointer user_data)
+{
+    auto* self = static_cast<NetworkThread*>(user_data);
+
+    // NOTE: libsoup attaches its sources to the thread-default context, so this is what ties the session to this thread.
+    g_main_context_push_thread_default(self->m_context);
+    g_main_loop_run(self->m_loop);
+    g_main_context_pop_thread_default(self->m_context);
+    return nullptr;
+}
+
+void NetworkThread::run(Function<void()> callback)
+{
+    g_main_context_invoke_full(
+        m_context,
+        G_PRIORITY_DEFAULT,
+        [](gpointer data) -> gboolean {
+            (*static_cast<Function<void()>*>(data))();
+            return G_SOURCE_REMOVE;
+        },
+        new Function<void()>(move(callback)),
+        [](gpointer data) { delete static_cast<Function<void()>*>(data); });
+}
+
+void NetworkThread::run_and_wait(Function<void()> callback)
+{
+    bool done = false;
+    run([&] {
+        callback();
+
+        g_mutex_lock(&m_mutex);
+        done = true;
+        g_cond_signal(&m_condition);
+        g_mutex_unlock(&m_mutex);
+    });
+
+    g_mutex_lock(&m_mutex);
+    while (!done)
+        g_cond_wait(&m_condition, &m_mutex);
+    g_mutex_unlock(&m_mutex);
+}
+
+void NetworkThread::post_to_main_thread(Function<void()> callback)
+{
+    g_mutex_lock(&m_mutex);
+    m_main_thread_queue.append(move(callback));
+    bool needs_wake = !m_main_thread_wake_pending;
+    m_main_thread_wake_pending = true;
+    g_mutex_unlock(&m_mutex);
+
+    // NOTE: Not g_main_context_invoke(), that would run the queue right here if we happened to be on the main thread.
+    if (needs_wake) {
+        auto* source = g_idle_source_new();
+        g_source_set_priority(source, G_PRIORITY_DEFAULT);
+        g_source_set_callback(source, drain_main_thread_queue, this, nullptr);
+        g_source_attach(source, nullptr);
+        g_source_unref(source);
+    }
+}
+
+gboolean NetworkThread::drain_main_thread_queue(gpointer user_data)
+{
+    auto* self = static_cast<NetworkThread*>(user_data);
+
+    g_mutex_lock(&self->m_mutex);
+    auto queue = move(self->m_main_thread_queue);
+    self->m_main_thread_wake_pending = false;
+    g_mutex_unlock(&self->m_mutex);
+
+    for (auto& callback : queue)
+        callback();
+    return G_SOURCE_REMOVE;
+}
+
+}
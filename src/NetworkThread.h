@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+#include <glib.h>
+
+namespace Ladybird {
+
+// A thread with its own GMainContext, so that sockets keep being read while the main thread is busy running JavaScript or laying out.
+// Work finished on it comes back to the main thread in batches, a single wake-up for everything that completed in the meantime.
+class NetworkThread {
+    AK_MAKE_NONCOPYABLE(NetworkThread);
+    AK_MAKE_NONMOVABLE(NetworkThread);
+
+public:
+    NetworkThread();
+    ~NetworkThread();
+
+    void run(Function<void()>);
+    void run_and_wait(Function<void()>);
+
+    // May be called from either thread.
+    void post_to_main_thread(Function<void()>);
+
+private:
+    static gpointer thread_main(gpointer);
+    static gboolean drain_main_thread_queue(gpointer);
+
+    GMainContext* m_context { nullptr };
+    GMainLoop* m_loop { nullptr };
+    GThread* m_thread { nullptr };
+
+    GMutex m_mutex;
+    GCond m_condition;
+    Vector<Function<void()>> m_main_thread_queue;
+    bool m_main_thread_wake_pending { false };
+};
+
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "PreloadScanner.h"
+#include <AK/CharacterTypes.h>
+
+namespace Ladybird {
+
+// Past this, the parser has usually caught up with us anyway.
+static constexpr size_t MAX_SCANNED_BYTES = 1 * MiB;
+static constexpr size_t MAX_RESOURCES = 64;
+// A tag we've been waiting this long to see the end of isn't markup we understand.
+static constexpr size_t MAX_BUFFERED_BYTES = 64 * KiB;
+
+struct Attribute {
+    StringView name;
+    StringView value;
+};
+
+static Optional<size_t> find_tag_end(StringView text, size_t start)
+{
+    Optional<char> quote;
+    char last_non_space = 0;
+
+    for (size_t i = start; i < text.length(); ++i) {
+        auto c = text[i];
+        if (quote.has_value()) {
+            if (c == *quote)
+                quote.clear();
+            continue;
+        }
+        if (c == '>')
+            return i;
+        // NOTE: Only quotes that start an attribute value count, so an apostrophe in an unquoted value doesn't swallow the rest of the document.
+        if ((c == '"' || c == '\'') && last_non_space == '=')
+            quote = c;
+        if (!is_ascii_space(c))
+            last_non_space = c;
+    }
+    return {};
+}
+
+static Vector<Attribute> parse_attributes(StringView tag, size_t position)
+{
+    Vector<Attribute> attributes;
+
+    auto skip_spaces = [&] {
+        while (position < tag.length() && (is_ascii_space(tag[position]) || tag[position] == '/'))
+            ++position;
+    };
+
+    while (position < tag.length()) {
+        skip_spaces();
+
+        auto name_start = position;
+        while (position < tag.length() && !is_ascii_space(tag[position]) && tag[position] != '=' && tag[position] != '/')
+            ++position;
+        auto name = tag.substring_view(name_start, position - name_start);
+        if (name.is_empty()) {
+            ++position;
+            continue;
+        }
+
+        while (position < tag.length() && is_ascii_space(tag[position]))
+            ++position;
+
+        StringView value;
+        if (position < tag.length() && tag[position] == '=') {
+            ++position;
+            while (position < tag.length() && is_ascii_space(tag[position]))
+                ++position;
+
+            if (position < tag.length() && (tag[position] == '"' || tag[position] == '\'')) {
+                auto quote = tag[position++];
+                auto value_start = position;
+                while (position < tag.length() && tag[position] != quote)
+                    ++position;
+                value = tag.substring_view(value_start, position - value_start);
+                ++position;
+            } else {
+                auto value_start = position;
+                while (position < tag.length() && !is_ascii_space(tag[position]))
+                    ++position;
+                value = tag.substring_view(value_start, position - value_start);
+            }
+        }
+
+        attributes.append({ name, value });
+    }
+
+    return attributes;
+}
+
+PreloadScanner::PreloadScanner(DeprecatedString document_url)
+    : m_document_url(move(document_url))
+    , m_base_url(m_document_url)
+{
+}
+
+StringView PreloadScanner::accept_header_for(Destination destination)
+{
+    // NOTE: These are what Fetch asks for, so the responses are the ones LibWeb would have gotten itself.
+    switch (destination) {
+    case Destination::Script:
+        return "*/*"sv;
+    case Destination::Style:
+        return "text/css,*/*;q=0.1"sv;
+    case Destination::Image:
+        return "image/png,image/svg+xml,image/*;q=0.8,*/*;q=0.5"sv;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+Vector<PreloadScanner::Resource> PreloadScanner::feed(ReadonlyBytes bytes)
+{
+    Vector<Resource> resources;
+    if (m_is_done)
+        return resources;
+
+    m_bytes_scanned += bytes.size();
+    if (m_buffer.try_append(bytes).is_error()) {
+        m_is_done = true;
+        return resources;
+    }
+
+    StringView text { m_buffer.bytes() };
+    size_t position = 0;
+
+    while (position < text.length() && !m_is_done) {
+        if (m_state == State::Comment) {
+            auto end = text.find("-->"sv, position);
+            if (!end.has_value()) {
+                position = text.length() - min<size_t>(text.length() - position, 2);
+                break;
+            }
+            position = *end + 3;
+            m_state = State::Data;
+            continue;
+        }
+
+        if (m_state == State::RawText) {
+            Optional<size_t> end;
+            for (auto candidate = text.find("</"sv, position); candidate.has_value(); candidate = text.find("</"sv, *candidate + 2)) {
+                if (text.substring_view(*candidate).starts_with(m_raw_text_end, CaseSensitivity::CaseInsensitive)) {
+                    end = candidate;
+                    break;
+                }
+            }
+            if (!end.has_value()) {
+                position = text.length() - min<size_t>(text.length() - position, m_raw_text_end.length() - 1);
+                break;
+            }
+            position = *end + m_raw_text_end.length();
+            m_state = State::Data;
+            continue;
+        }
+
+        auto tag_start = text.find('<', position);
+        if (!tag_start.has_value()) {
+            position = text.length();
+            break;
+        }
+
+        if (text.substring_view(*tag_start).starts_with("<!--"sv)) {
+            position = *tag_start + 4;
+            m_state = State::Comment;
+            continue;
+        }
+
+        auto tag_end = find_tag_end(text, *tag_start + 1);
+        if (!tag_end.has_value()) {
+            position = *tag_start;
+            break;
+        }
+
+        process_tag(text.substring_view(*tag_start + 1, *tag_end - *tag_start - 1), resources);
+        position = *tag_end + 1;
+    }
+
+    auto remaining = text.substring_view(position);
+    if (remaining.length() > MAX_BUFFERED_BYTES || m_bytes_scanned >= MAX_SCANNED_BYTES)
+        m_is_done = true;
+
+    if (m_is_done) {
+        m_buffer.clear();
+        return resources;
+    }
+
+    auto buffer_or_error = ByteBuffer::copy(remaining.bytes());
+    if (buffer_or_error.is_error()) {
+        m_is_done = true;
+        return resources;
+    }
+    m_buffer = buffer_or_error.release_value();
+    return resources;
+}
+
+void PreloadScanner::process_tag(StringView tag, Vector<Resource>& resources)
+{
+    // End tags, doctypes and processing instructions have nothing for us.
+    if (tag.is_empty() || !is_ascii_alpha(tag[0]))
+        return;
+
+    size_t name_length = 0;
+    while (name_length < tag.length() && !is_ascii_space(tag[name_length]) && tag[name_length] != '/')
+        ++name_length;
+    auto name = tag.substring_view(0, name_length);
+
+    // NOTE: Most tags are none of the ones we care about, so don't bother with their attributes.
+    if (!name.is_one_of_ignoring_ascii_case("script"sv, "link"sv, "img"sv, "base"sv, "style"sv, "noscript"sv))
+        return;
+
+    auto attributes = parse_attributes(tag, name_length);
+    auto attribute = [&](StringView attribute_name) -> Optional<StringView> {
+        for (auto const& it : attributes) {
+            if (it.name.equals_ignoring_ascii_case(attribute_name))
+                return it.value;
+        }
+        return {};
+    };
+
+    if (name.equals_ignoring_ascii_case("script"sv)) {
+        if (auto src = attribute("src"sv); src.has_value())
+            found(*src, Destination::Script, resources);
+        m_state = State::RawText;
+        m_raw_text_end = "</script"sv;
+    } else if (name.equals_ignoring_ascii_case("style"sv)) {
+        m_state = State::RawText;
+        m_raw_text_end = "</style"sv;
+    } else if (name.equals_ignoring_ascii_case("noscript"sv)) {
+        // NOTE: We always run scripts, so nothing in here will be loaded.
+        m_state = State::RawText;
+        m_raw_text_end = "</noscript"sv;
+    } else if (name.equals_ignoring_ascii_case("img"sv)) {
+        if (auto src = attribute("src"sv); src.has_value())
+            found(*src, Destination::Image, resources);
+    } else if (name.equals_ignoring_ascii_case("link"sv)) {
+        auto href = attribute("href"sv);
+        if (!href.has_value())
+            return;
+
+        bool is_stylesheet = false;
+        bool is_alternate = false;
+        bool is_preload = false;
+        bool is_module_preload = false;
+        for (auto token : attribute("rel"sv).value_or({}).split_view_if(is_ascii_space)) {
+            is_stylesheet |= token.equals_ignoring_ascii_case("stylesheet"sv);
+            is_alternate |= token.equals_ignoring_ascii_case("alternate"sv);
+            is_preload |= token.equals_ignoring_ascii_case("preload"sv);
+            is_module_preload |= token.equals_ignoring_ascii_case("modulepreload"sv);
+        }
+
+        if (is_stylesheet && !is_alternate) {
+            found(*href, Destination::Style, resources);
+        } else if (is_module_preload) {
+            found(*href, Destination::Script, resources);
+        } else if (is_preload) {
+            auto as = attribute("as"sv).value_or({});
+            if (as.equals_ignoring_ascii_case("script"sv))
+                found(*href, Destination::Script, resources);
+            else if (as.equals_ignoring_ascii_case("style"sv))
+                found(*href, Destination::Style, resources);
+            else if (as.equals_ignoring_ascii_case("image"sv))
+                found(*href, Destination::Image, resources);
+        }
+    } else if (name.equals_ignoring_ascii_case("base"sv)) {
+        // Only the first <base href> counts.
+        auto href = attribute("href"sv);
+        if (m_has_base_element || !href.has_value())
+            return;
+        m_has_base_element = true;
+        if (auto base_url = m_base_url.complete_url(*href); base_url.is_valid())
+            m_base_url = move(base_url);
+    }
+}
+
+void PreloadScanner::found(StringView url, Destination destination, Vector<Resource>& resources)
+{
+    url = url.trim_whitespace();
+    if (url.is_empty())
+        return;
+
+    // NOTE: &amp; is the only character reference that shows up in URLs with any regularity.
+    DeprecatedString value = url.contains("&amp;"sv) ? url.replace("&amp;"sv, "&"sv, ReplaceMode::All) : DeprecatedString { url };
+
+    auto resolved = m_base_url.complete_url(value);
+    if (!resolved.is_valid() || !resolved.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv))
+        return;
+
+    auto serialized = resolved.serialize(AK::URL::ExcludeFragment::Yes);
+    if (m_seen.contains(serialized))
+        return;
+
+    // NOTE: The resource gets a string of its own, as reference counts can't be shared with the thread it's handed to.
+    resources.append({ DeprecatedString { serialized.view() }, destination });
+    m_seen.set(move(serialized));
+    if (m_seen.size() >= MAX_RESOURCES)
+        m_is_done = true;
+}
+
+}
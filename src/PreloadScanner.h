@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashTable.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+
+namespace Ladybird {
+
+// Looks through a document's markup as it comes off the network for the subresources it's going to need,
+// so they can be fetched before LibWeb's parser gets far enough to ask for them.
+// NOTE: This is deliberately no HTML tokenizer, it only has to be right about the common cases and must never be slow.
+class PreloadScanner {
+public:
+    enum class Destination {
+        Script,
+        Style,
+        Image,
+    };
+
+    struct Resource {
+        // NOTE: A string rather than an AK::URL, as resources are found on the network thread and handed over to the main thread.
+        DeprecatedString url;
+        Destination destination;
+    };
+
+    struct Statistics {
+        u64 issued { 0 };
+        u64 used { 0 };
+        u64 wasted { 0 };
+    };
+
+    explicit PreloadScanner(DeprecatedString document_url);
+
+    Vector<Resource> feed(ReadonlyBytes);
+    bool is_done() const { return m_is_done; }
+
+    static StringView accept_header_for(Destination);
+
+private:
+    enum class State {
+        Data,
+        Comment,
+        RawText,
+    };
+
+    void process_tag(StringView tag, Vector<Resource>&);
+    void found(StringView url, Destination, Vector<Resource>&);
+
+    DeprecatedString m_document_url;
+    AK::URL m_base_url;
+    bool m_has_base_element { false };
+
+    State m_state { State::Data };
+    StringView m_raw_text_end;
+    ByteBuffer m_buffer;
+
+    size_t m_bytes_scanned { 0 };
+    HashTable<DeprecatedString> m_seen;
+    bool m_is_done { false };
+};
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RequestBody.h"
+
+namespace Ladybird {
+
+RequestBody RequestBody::create_from_bytes(ReadonlyBytes bytes)
+{
+    GBytes* copy = g_bytes_new(bytes.data(), bytes.size());
+    GInputStream* stream = g_memory_input_stream_new_from_bytes(copy);
+    g_bytes_unref(copy);
+    return RequestBody(stream, bytes.size());
+}
+
+RequestBody::RequestBody(GInputStream* stream, u64 size)
+    : m_stream(stream)
+    , m_size(size)
+{
+}
+
+RequestBody::RequestBody(RequestBody&& other)
+    : m_stream(exchange(other.m_stream, nullptr))
+    , m_size(other.m_size)
+{
+}
+
+RequestBody::~RequestBody()
+{
+    if (m_stream)
+        g_object_unref(m_stream);
+}
+
+}
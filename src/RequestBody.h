@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <gio/gio.h>
+
+namespace Ladybird {
+
+// An upload body that libsoup reads from as the request is written.
+// The stream is seekable, so libsoup can rewind it when a request is restarted (e.g. on a 307 redirect).
+class RequestBody {
+    AK_MAKE_NONCOPYABLE(RequestBody);
+
+public:
+    // NOTE: LibWeb makes no promise that the span outlives start_request(), so this takes a copy we own.
+    //       That's a second copy of the whole upload next to LibWeb's, for as long as the request runs.
+    static RequestBody create_from_bytes(ReadonlyBytes);
+
+    RequestBody(RequestBody&&);
+    ~RequestBody();
+
+    GInputStream* stream() const { return m_stream; }
+    u64 size() const { return m_size; }
+
+private:
+    RequestBody(GInputStream*, u64 size);
+
+    GInputStream* m_stream { nullptr };
+    u64 m_size { 0 };
+};
+
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "HttpCache.h"
+#include "NetworkConditions.h"
+#include "PreloadScanner.h"
+#include "RequestTiming.h"
+#include <AK/Function.h>
+#include <AK/HashTable.h>
+#include <AK/Vector.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Ladybird {
+
+struct TlsStatistics {
+    u64 handshakes { 0 };
+    // Handshakes we had an earlier session with the same origin to offer for.
+    u64 resumption_attempts { 0 };
+    // NOTE: Stays 0 with TLS backends that can't tell us whether a session was resumed.
+    u64 resumed { 0 };
+    // Microseconds, summed over every handshake.
+    u64 handshake_time { 0 };
+};
+
+// The connector WebContent hands to LibWeb. This is either RequestManagerSoup doing the work in-process,
+// or RequestManagerNetworkServer forwarding everything to the shared NetworkServer process.
+class RequestManager : public Web::ResourceLoaderConnector {
+public:
+    virtual ~RequestManager() override = default;
+
+    virtual Optional<HttpCache::Statistics> http_cache_statistics() = 0;
+    virtual void set_network_conditions(NetworkConditions const&) = 0;
+    virtual PreloadScanner::Statistics preload_statistics() = 0;
+    virtual TlsStatistics tls_statistics() = 0;
+
+    // Fetches a URL into the HTTP cache ahead of time, for a request the page is expected to make soon.
+    virtual void prefetch(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers) = 0;
+
+    Function<void(AK::URL const&, u64 bytes_sent, u64 total_bytes)> on_upload_progress;
+
+    // Requests for these schemes are answered by the embedder, through on_custom_scheme_request.
+    void register_custom_scheme(DeprecatedString const& scheme) { m_custom_schemes.set(scheme.to_lowercase()); }
+    Function<NonnullRefPtr<Web::ResourceLoaderConnectorRequest>(AK::URL const&)> on_custom_scheme_request;
+
+    void set_records_timings(bool records_timings) { m_records_timings = records_timings; }
+    void record_timing(RequestTiming timing)
+    {
+        if (!m_records_timings)
+            return;
+        if (m_timings.size() >= max_recorded_timings)
+            m_timings.remove(0);
+        m_timings.append(move(timing));
+    }
+
+    Vector<RequestTiming> const& timings() const { return m_timings; }
+    void clear_timings() { m_timings.clear(); }
+
+    // How many requests were answered by an identical one that was already in flight.
+    u64 coalesced_request_count() const { return m_coalesced_request_count; }
+    void did_coalesce_request() { ++m_coalesced_request_count; }
+
+protected:
+    bool is_custom_scheme(AK::URL const& url) const
+    {
+        return on_custom_scheme_request && m_custom_schemes.contains(url.scheme().to_lowercase());
+    }
+
+private:
+    static constexpr size_t max_recorded_timings = 2000;
+
+    HashTable<DeprecatedString> m_custom_schemes;
+
+    Vector<RequestTiming> m_timings;
+    bool m_records_timings { true };
+    u64 m_coalesced_request_count { 0 };
+};
+
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RequestManagerNetworkServer.h"
+#include "MappedFileRequest.h"
+
+namespace Ladybird {
+
+RequestManagerNetworkServer::RequestManagerNetworkServer(NonnullRefPtr<NetworkServerClient> client)
+    : m_client(move(client))
+{
+    m_client->on_request_finished = [this](i32 request_id, bool success, Optional<u32> status_code, auto const& response_headers, Core::AnonymousBuffer const& body, RequestTiming const& timing, bool coalesced) {
+        // NOTE: Requests that never made it into the server's SoupSession have nothing to report.
+        if (!timing.url.is_empty())
+            record_timing(timing);
+        // NOTE: The server merges requests across every view, so count them here to know which view benefited.
+        if (coalesced)
+            did_coalesce_request();
+        did_finish_request(request_id, success, status_code, response_headers, body);
+    };
+
+    m_client->on_request_upload_progress = [this](i32 request_id, u64 bytes_sent, u64 total_bytes) {
+        auto request = m_pending.get(request_id);
+        if (request.has_value() && on_upload_progress)
+            on_upload_progress((*request)->url(), bytes_sent, total_bytes);
+    };
+
+    m_client->on_death = [this] {
+        did_lose_server();
+    };
+}
+
+RefPtr<Web::ResourceLoaderConnectorRequest> RequestManagerNetworkServer::start_request(DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&)
+{
+    // NOTE: Local files are read right here, there's nothing the NetworkServer could add.
+    if (url.scheme().equals_ignoring_ascii_case("file"sv))
+        return MappedFileRequest::create(url);
+    if (is_custom_scheme(url))
+        return on_custom_scheme_request(url);
+
+    if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv)) {
+        return nullptr;
+    }
+
+    if (m_server_is_gone)
+        return nullptr;
+
+    // NOTE: Like responses, request bodies go over shared memory rather than through the socket.
+    Core::AnonymousBuffer body;
+    if (!request_body.is_empty()) {
+        auto body_or_error = Core::AnonymousBuffer::create_with_size(request_body.size());
+        if (body_or_error.is_error()) {
+            dbgln("Unable to allocate {} bytes for request body: {}", request_body.size(), body_or_error.error());
+            return nullptr;
+        }
+        body = body_or_error.release_value();
+        request_body.copy_to(Bytes { body.data<u8>(), body.size() });
+    }
+
+    auto request_id = m_next_request_id++;
+    auto request = adopt_ref(*new Request(url));
+    m_pending.set(request_id, request);
+
+    m_client->async_start_request(request_id, method, url, request_headers, body);
+    return request;
+}
+
+void RequestManagerNetworkServer::did_finish_request(i32 request_id, bool success, Optional<u32> status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Core::AnonymousBuffer const& body)
+{
+    auto request = m_pending.take(request_id);
+    if (!request.has_value())
+        return;
+
+    ReadonlyBytes payload;
+    if (body.is_valid())
+        payload = body.bytes();
+
+    (*request)->on_buffered_request_finish(success, payload.size(), response_headers, status_code, payload);
+}
+
+void RequestManagerNetworkServer::did_lose_server()
+{
+    dbgln("Lost connection to NetworkServer, failing {} pending requests", m_pending.size());
+    m_server_is_gone = true;
+
+    auto pending = move(m_pending);
+    for (auto& it : pending)
+        it.value->on_buffered_request_finish(false, 0, {}, {}, {});
+}
+
+void RequestManagerNetworkServer::prefetch_dns(AK::URL const& url)
+{
+    if (!m_server_is_gone)
+        m_client->async_prefetch_dns(url);
+}
+
+void RequestManagerNetworkServer::preconnect(AK::URL const& url)
+{
+    if (!m_server_is_gone)
+        m_client->async_preconnect(url);
+}
+
+void RequestManagerNetworkServer::prefetch(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    if (!m_server_is_gone)
+        m_client->async_prefetch(url, request_headers);
+}
+
+Optional<HttpCache::Statistics> RequestManagerNetworkServer::http_cache_statistics()
+{
+    if (m_server_is_gone)
+        return {};
+
+    auto response = m_client->get_http_cache_statistics();
+    if (!response.enabled())
+        return {};
+
+    return HttpCache::Statistics {
+        .memory_hits = response.memory_hits(),
+        .disk_hits = response.disk_hits(),
+        .revalidations = response.revalidations(),
+        .misses = response.misses(),
+        .stores = response.stores(),
+        .evictions = response.evictions(),
+        .memory_size = response.memory_size(),
+        .disk_size = response.disk_size(),
+    };
+}
+
+PreloadScanner::Statistics RequestManagerNetworkServer::preload_statistics()
+{
+    if (m_server_is_gone)
+        return {};
+
+    // NOTE: Like the cache these are the server's, so they cover every view of the application.
+    auto response = m_client->get_preload_statistics();
+    return { response.issued(), response.used(), response.wasted() };
+}
+
+TlsStatistics RequestManagerNetworkServer::tls_statistics()
+{
+    if (m_server_is_gone)
+        return {};
+
+    auto response = m_client->get_tls_statistics();
+    return { response.handshakes(), response.resumption_attempts(), response.resumed(), response.handshake_time() };
+}
+
+void RequestManagerNetworkServer::set_network_conditions(NetworkConditions const& conditions)
+{
+    if (m_server_is_gone)
+        return;
+
+    // NOTE: The server has one SoupSession for everyone, so this emulates the link for every view of the application.
+    m_client->async_set_network_conditions(conditions.latency_ms, conditions.download_throughput, conditions.upload_throughput, conditions.failure_rate);
+}
+
+}
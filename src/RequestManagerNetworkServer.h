@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "NetworkServerClient.h"
+#include "RequestManager.h"
+
+namespace Ladybird {
+
+// Sends every request to the application's NetworkServer, so all of its WebContent processes share one SoupSession.
+class RequestManagerNetworkServer final : public RequestManager {
+public:
+    static NonnullRefPtr<RequestManagerNetworkServer> create(NonnullRefPtr<NetworkServerClient> client)
+    {
+        return adopt_ref(*new RequestManagerNetworkServer(move(client)));
+    }
+
+    virtual ~RequestManagerNetworkServer() override = default;
+
+    virtual void prefetch_dns(AK::URL const&) override;
+    virtual void preconnect(AK::URL const&) override;
+
+    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(DeprecatedString const& method, AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&) override;
+
+    virtual Optional<HttpCache::Statistics> http_cache_statistics() override;
+    virtual void set_network_conditions(NetworkConditions const&) override;
+    virtual PreloadScanner::Statistics preload_statistics() override;
+    virtual TlsStatistics tls_statistics() override;
+    virtual void prefetch(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers) override;
+
+private:
+    explicit RequestManagerNetworkServer(NonnullRefPtr<NetworkServerClient>);
+
+    class Request
+        : public Web::ResourceLoaderConnectorRequest {
+    public:
+        explicit Request(AK::URL url)
+            : m_url(move(url))
+        {
+        }
+
+        virtual ~Request() override = default;
+
+        virtual void set_should_buffer_all_input(bool) override { }
+        virtual bool stop() override { return false; }
+        virtual void stream_into(Stream&) override { }
+
+        AK::URL const& url() const { return m_url; }
+
+    private:
+        AK::URL m_url;
+    };
+
+    void did_finish_request(i32 request_id, bool success, Optional<u32> status_code, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Core::AnonymousBuffer const& body);
+    void did_lose_server();
+
+    NonnullRefPtr<NetworkServerClient> m_client;
+    HashMap<i32, NonnullRefPtr<Request>> m_pending;
+    i32 m_next_request_id { 0 };
+    bool m_server_is_gone { false };
+};
+
+}
@@ -5,38 +5,616 @@
  */
 
 #include "RequestManagerSoup.h"
+#include "MappedFileRequest.h"
+#include "RequestBody.h"
+#include "ResponseHeaders.h"
 #include "Utilities.h"
 #include <AK/JsonObject.h>
+#include <AK/Random.h>
+#include <LibCore/EventLoop.h>
 
-RequestManagerSoup::RequestManagerSoup()
+#ifdef HAVE_ZSTD
+#    include "ZstdDecompressor.h"
+#endif
+
+static constexpr gsize READ_CHUNK_SIZE = 64 * KiB;
+// A speculative response nobody asked for by then is counted as wasted.
+static constexpr i64 SPECULATIVE_REQUEST_LIFETIME = 30'000'000;
+static constexpr size_t MAX_SPECULATIVE_REQUESTS = 256;
+// NOTE: What we keep to resume a session from is the whole GTlsClientConnection that negotiated it, as GIO doesn't hand out
+//       session state any other way. Each one holds on to its TLS state and I/O buffers, easily some tens of KiB, for as long
+//       as it's in here, even after libsoup has closed it. So keep only a few, and not for longer than servers tend to honour them.
+static constexpr size_t MAX_TLS_SESSIONS = 8;
+static constexpr i64 TLS_SESSION_LIFETIME = 300'000'000;
+// Idle connections stay in libsoup's pool for about this long, there's no point in opening another before then.
+static constexpr i64 PRECONNECT_INTERVAL = 10'000'000;
+// NOTE: A request that's still going after this long is most likely streaming or long-polling, and may well go on for
+//       as long as the page is open. It keeps going, but hands its scheduler slot back so it can't hold up everything else.
+//       (Releasing on the first body chunk instead would miss long-polls, which don't send anything until they finish.)
+static constexpr guint SCHEDULER_SLOT_TIMEOUT_MS = 10'000;
+
+RequestManagerSoup::RequestManagerSoup(Ladybird::NetworkSettings const& settings)
+    : m_scheduler(settings.max_connections)
+{
+    auto create_session = [&] {
+        m_session = soup_session_new_with_options(
+                "max-conns", static_cast<int>(settings.max_connections),
+                "max-conns-per-host", static_cast<int>(settings.max_connections_per_host),
+                nullptr);
+
+        // NOTE: The content decoder negotiates Accept-Encoding and transparently decodes gzip, deflate and (if libsoup was built with it) brotli.
+        //       libsoup3 adds it by default, but we rely on it for correctness so make sure it's there.
+        if (!soup_session_has_feature(m_session, SOUP_TYPE_CONTENT_DECODER))
+            soup_session_add_feature_by_type(m_session, SOUP_TYPE_CONTENT_DECODER);
+    };
+
+    // NOTE: A session belongs to the main context it was created on, so it has to be created on the network thread to be driven from there.
+    if (settings.use_network_thread) {
+        m_network_thread = make<Ladybird::NetworkThread>();
+        m_network_thread->run_and_wait(move(create_session));
+    } else {
+        create_session();
+    }
+
+    if (settings.network_archive_mode != Ladybird::NetworkArchiveMode::Off) {
+        auto archive_or_error = settings.network_archive_mode == Ladybird::NetworkArchiveMode::Record
+            ? Ladybird::NetworkArchive::open_for_recording(settings.network_archive_path)
+            : Ladybird::NetworkArchive::open_for_replay(settings.network_archive_path);
+        if (archive_or_error.is_error())
+            dbgln("Unable to open network archive {}: {}", settings.network_archive_path, archive_or_error.error());
+        else
+            m_archive = archive_or_error.release_value();
+        m_replays_original_latency = settings.network_archive_original_latency;
+    }
+
+    m_preload_scanner_enabled = settings.preload_scanner_enabled;
+
+    // NOTE: Cache hits would never make it into a recording, and a replay shouldn't depend on what happened to be cached beforehand.
+    if (settings.http_cache_enabled && !m_archive) {
+        m_http_cache = make<Ladybird::HttpCache>(Ladybird::HttpCache::Configuration {
+            .directory = settings.http_cache_directory,
+            .memory_size = settings.http_cache_memory_size,
+            .disk_size = settings.http_cache_disk_size,
+        });
+    }
+
+    set_network_conditions(settings.network_conditions);
+}
+
+RequestManagerSoup::~RequestManagerSoup()
+{
+    auto release_tls_sessions = [this] {
+        for (auto& it : m_tls_sessions)
+            g_object_unref(it.value.connection);
+        m_tls_sessions.clear();
+    };
+
+    if (m_network_thread)
+        m_network_thread->run_and_wait(move(release_tls_sessions));
+    else
+        release_tls_sessions();
+}
+
+void RequestManagerSoup::set_network_conditions(Ladybird::NetworkConditions const& conditions)
+{
+    m_network_conditions = conditions;
+    run_on_network_thread([this, rate = conditions.download_throughput] {
+        m_download_bucket.set_rate(rate);
+    });
+    m_upload_bucket.set_rate(conditions.upload_throughput);
+}
+
+void RequestManagerSoup::run_on_network_thread(Function<void()> callback)
+{
+    if (m_network_thread)
+        m_network_thread->run(move(callback));
+    else
+        callback();
+}
+
+void RequestManagerSoup::run_on_main_thread(Function<void()> callback)
+{
+    if (m_network_thread)
+        m_network_thread->post_to_main_thread(move(callback));
+    else
+        callback();
+}
+
+Optional<Ladybird::HttpCache::Statistics> RequestManagerSoup::http_cache_statistics()
+{
+    if (!m_http_cache)
+        return {};
+    return m_http_cache->statistics();
+}
+
+static bool is_cacheable_request(DeprecatedString const& method, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    if (!method.equals_ignoring_ascii_case("get"sv))
+        return false;
+
+    for (auto const& it : request_headers) {
+        // Conditional and range requests made by the page itself go straight to the network.
+        if (it.key.is_one_of_ignoring_ascii_case("if-none-match"sv, "if-modified-since"sv, "if-match"sv, "if-unmodified-since"sv, "if-range"sv, "range"sv))
+            return false;
+        if (it.key.equals_ignoring_ascii_case("cache-control"sv) && Ladybird::HttpCache::CacheControl::parse(it.value).no_store)
+            return false;
+    }
+    return true;
+}
+
+struct RequestCacheDirectives {
+    bool requires_revalidation { false };
+    Optional<i64> max_age;
+};
+
+static RequestCacheDirectives cache_directives_for_request(HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    RequestCacheDirectives directives;
+    for (auto const& it : request_headers) {
+        if (it.key.equals_ignoring_ascii_case("cache-control"sv)) {
+            auto cache_control = Ladybird::HttpCache::CacheControl::parse(it.value);
+            directives.requires_revalidation |= cache_control.no_cache;
+            directives.max_age = cache_control.max_age;
+        } else if (it.key.equals_ignoring_ascii_case("pragma"sv) && it.value.contains("no-cache"sv, CaseSensitivity::CaseInsensitive)) {
+            directives.requires_revalidation = true;
+        }
+    }
+    return directives;
+}
+
+// NOTE: LibWeb doesn't tell us what a request is for, so go by what Fetch put in the Accept header, and failing that, the URL.
+static Ladybird::RequestScheduler::Priority priority_for_request(DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    using Priority = Ladybird::RequestScheduler::Priority;
+
+    if (!method.is_one_of_ignoring_ascii_case("get"sv, "head"sv))
+        return Priority::Normal;
+
+    for (auto const& it : request_headers) {
+        if (!it.key.equals_ignoring_ascii_case("accept"sv))
+            continue;
+        if (it.value.starts_with("text/html"sv) || it.value.starts_with("text/css"sv))
+            return Priority::RenderBlocking;
+        if (it.value.starts_with("image/"sv))
+            return Priority::Low;
+        break;
+    }
+
+    auto path = url.serialize_path();
+    auto has_extension = [&](auto... extensions) {
+        return (path.ends_with(extensions, CaseSensitivity::CaseInsensitive) || ...);
+    };
+
+    if (has_extension(".css"sv))
+        return Priority::RenderBlocking;
+    if (has_extension(".js"sv, ".mjs"sv, ".woff"sv, ".woff2"sv, ".ttf"sv, ".otf"sv))
+        return Priority::High;
+    if (has_extension(".png"sv, ".jpg"sv, ".jpeg"sv, ".gif"sv, ".webp"sv, ".svg"sv, ".ico"sv, ".bmp"sv, ".mp3"sv, ".mp4"sv, ".ogg"sv, ".webm"sv, ".wav"sv))
+        return Priority::Low;
+    return Priority::Normal;
+}
+
+static SoupMessagePriority soup_priority_for(Ladybird::RequestScheduler::Priority priority)
+{
+    switch (priority) {
+    case Ladybird::RequestScheduler::Priority::RenderBlocking:
+        return SOUP_MESSAGE_PRIORITY_VERY_HIGH;
+    case Ladybird::RequestScheduler::Priority::High:
+        return SOUP_MESSAGE_PRIORITY_HIGH;
+    case Ladybird::RequestScheduler::Priority::Normal:
+        return SOUP_MESSAGE_PRIORITY_NORMAL;
+    case Ladybird::RequestScheduler::Priority::Low:
+        return SOUP_MESSAGE_PRIORITY_LOW;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+int RequestManagerSoup::Request::io_priority() const
+{
+    // NOTE: Keep all of these close to G_PRIORITY_DEFAULT, we don't want image data to wait for idle callbacks.
+    switch (m_priority) {
+    case Ladybird::RequestScheduler::Priority::RenderBlocking:
+        return G_PRIORITY_DEFAULT - 20;
+    case Ladybird::RequestScheduler::Priority::High:
+        return G_PRIORITY_DEFAULT - 10;
+    case Ladybird::RequestScheduler::Priority::Low:
+        return G_PRIORITY_DEFAULT + 10;
+    default:
+        return G_PRIORITY_DEFAULT;
+    }
+}
+
+// NOTE: Core::deferred_invoke() has no notion of time (nor of threads), so delayed callbacks go straight to GLib.
+//       They run on the calling thread's own main context, which also makes this usable from the network thread.
+static void invoke_after(i64 microseconds, Function<void()> callback)
+{
+    auto* source = g_timeout_source_new(static_cast<guint>(max<i64>(0, microseconds) / 1000));
+    g_source_set_callback(
+        source,
+        [](gpointer user_data) -> gboolean {
+            (*static_cast<Function<void()>*>(user_data))();
+            return G_SOURCE_REMOVE;
+        },
+        new Function<void()>(move(callback)),
+        [](gpointer user_data) { delete static_cast<Function<void()>*>(user_data); });
+    g_source_attach(source, g_main_context_get_thread_default());
+    g_source_unref(source);
+}
+
+static Optional<DeprecatedString> find_request_header(HashMap<DeprecatedString, DeprecatedString> const& request_headers, StringView name)
+{
+    for (auto const& it : request_headers) {
+        if (it.key.equals_ignoring_ascii_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+// NOTE: We can't know what a response will Vary on until it arrives, so only merge requests that agree on what responses commonly vary on.
+//       Anything else named by Vary is checked once the response is in, see varied_headers_match().
+static DeprecatedString coalescing_key_for(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    StringBuilder builder;
+    builder.append(url.serialize(AK::URL::ExcludeFragment::Yes));
+    for (auto name : { "accept"sv, "accept-language"sv, "authorization"sv, "cookie"sv, "origin"sv }) {
+        builder.append('\n');
+        builder.append(find_request_header(request_headers, name).value_or({}));
+    }
+    return builder.to_deprecated_string();
+}
+
+static bool varied_headers_match(Ladybird::HttpCache::HeaderMap const& response_headers, HashMap<DeprecatedString, DeprecatedString> const& a, HashMap<DeprecatedString, DeprecatedString> const& b)
+{
+    auto vary = response_headers.get("Vary"sv);
+    if (!vary.has_value())
+        return true;
+
+    for (auto name : vary->split_view(',')) {
+        name = name.trim_whitespace();
+        if (name == "*"sv)
+            return false;
+        if (find_request_header(a, name) != find_request_header(b, name))
+            return false;
+    }
+    return true;
+}
+
+// NOTE: Speculative requests can't know every header the page is going to send, so never hand one over to a request with other credentials.
+static bool credentials_match(HashMap<DeprecatedString, DeprecatedString> const& a, HashMap<DeprecatedString, DeprecatedString> const& b)
+{
+    for (auto name : { "authorization"sv, "cookie"sv }) {
+        if (find_request_header(a, name) != find_request_header(b, name))
+            return false;
+    }
+    return true;
+}
+
+static bool is_document_request(DeprecatedString const& method, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    if (!method.equals_ignoring_ascii_case("get"sv))
+        return false;
+    auto accept = find_request_header(request_headers, "accept"sv);
+    return accept.has_value() && accept->starts_with("text/html"sv);
+}
+
+static void set_request_body(SoupMessage* message, Ladybird::RequestBody body)
+{
+    // NOTE: No content type here, the page's own Content-Type is added along with the rest of its headers.
+    soup_message_set_request_body(message, nullptr, body.stream(), static_cast<gssize>(body.size()));
+}
+
+// NOTE: This and everything up to the end of the body runs on the network thread, if there is one.
+//       The request itself is kept alive by m_pending on the main thread, which is also where it gets taken out again.
+void RequestManagerSoup::reply_received(SoupSession* session, GAsyncResult* result, gpointer user_data)
 {
-    m_session = soup_session_new();
+    auto *request = static_cast<Request *>(user_data);
+    request->did_receive_response(session, result);
 }
 
-void RequestManagerSoup::reply_finished(SoupSession* session, GAsyncResult* result, gpointer user_data)
+#ifdef HAVE_ZSTD
+static bool is_zstd_encoded(SoupMessageHeaders* response_headers)
 {
-    auto *self = static_cast<RequestManagerSoup *>(user_data);
-    SoupMessage *reply = soup_session_get_async_result_message(session, result);
-    auto request = self->m_pending.get(reply).value();
-    self->m_pending.remove(reply);
-    request->did_finish(session, reply, result);
+    auto const* content_encoding = soup_message_headers_get_list(response_headers, "Content-Encoding");
+    if (!content_encoding)
+        return false;
+    return StringView { content_encoding, strlen(content_encoding) }.trim_whitespace().equals_ignoring_ascii_case("zstd"sv);
 }
 
+void RequestManagerSoup::message_starting(SoupMessage* message, gpointer)
+{
+    // NOTE: The content decoder fills in its own Accept-Encoding when the message is queued, so extend it here rather than guess what it supports.
+    auto* request_headers = soup_message_get_request_headers(message);
+    auto const* accept_encoding = soup_message_headers_get_one(request_headers, "Accept-Encoding");
+    if (!accept_encoding) {
+        soup_message_headers_replace(request_headers, "Accept-Encoding", "zstd");
+        return;
+    }
+    if (soup_header_contains(accept_encoding, "zstd"))
+        return;
+
+    auto extended = DeprecatedString::formatted("{}, zstd", accept_encoding);
+    soup_message_headers_replace(request_headers, "Accept-Encoding", extended.characters());
+}
+#endif
+
 RefPtr<Web::ResourceLoaderConnectorRequest> RequestManagerSoup::start_request(DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const& proxy)
+{
+    if (url.scheme().equals_ignoring_ascii_case("file"sv))
+        return Ladybird::MappedFileRequest::create(url);
+    if (is_custom_scheme(url))
+        return on_custom_scheme_request(url);
+
+    return begin_request(Initiator::Page, method, url, request_headers, request_body, proxy);
+}
+
+RefPtr<RequestManagerSoup::Request> RequestManagerSoup::begin_request(Initiator initiator, DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const& proxy)
 {
     if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv)) {
         return nullptr;
     }
-    auto request_or_error = create_request(m_session, method, url, request_headers, request_body, proxy);
+
+    if (m_archive && m_archive->is_replaying())
+        return replay_request(method, url);
+
+    Optional<SpeculativeRequest> speculation;
+    if (initiator == Initiator::Page)
+        speculation = take_speculative_request(method, url, request_headers);
+
+    auto is_cacheable = m_http_cache && is_cacheable_request(method, request_headers);
+    RefPtr<Ladybird::HttpCache::Entry> revalidating_entry;
+
+    if (is_cacheable) {
+        if (auto lookup = m_http_cache->lookup(url, request_headers); lookup.has_value()) {
+            auto directives = cache_directives_for_request(request_headers);
+            // NOTE: Like a browser's prefetch cache, a response fetched on speculation may be used once whether it's still fresh or not.
+            auto is_speculated_response = speculation.has_value() && lookup->entry->request_time() >= speculation->cache_time;
+            if (!directives.requires_revalidation && (is_speculated_response || lookup->entry->is_fresh(Ladybird::HttpCache::current_time(), directives.max_age))) {
+                m_http_cache->did_hit(lookup->tier);
+                if (speculation.has_value())
+                    ++m_preload_statistics.used;
+
+                // NOTE: LibWeb only hooks up its callbacks once we've returned the request, so finish on the next event loop iteration.
+                auto request = adopt_ref(*new Request(*this, nullptr));
+                request->m_method = method;
+                request->m_url = url;
+                Core::deferred_invoke([request, entry = move(lookup->entry)] {
+                    request->did_finish_from_cache(*entry);
+                });
+                return request;
+            }
+
+            if (lookup->entry->has_validators())
+                revalidating_entry = move(lookup->entry);
+        }
+
+        if (revalidating_entry)
+            m_http_cache->did_revalidate();
+        else
+            m_http_cache->did_miss();
+    }
+
+    if (speculation.has_value() && speculation->in_flight) {
+        auto request = adopt_ref(*new Request(*this, nullptr));
+        request->m_method = method;
+        request->m_url = url;
+        request->m_request_headers = request_headers;
+        speculation->in_flight->m_coalesced_requests.append(request);
+        ++m_preload_statistics.used;
+        return request;
+    }
+
+    if (speculation.has_value())
+        ++m_preload_statistics.wasted;
+
+    // Identical GETs already on their way (say, the same script for a page and its iframes) share that one transfer.
+    DeprecatedString coalescing_key;
+    if (is_cacheable_request(method, request_headers)) {
+        coalescing_key = coalescing_key_for(url, request_headers);
+        if (auto leader = m_in_flight_requests.get(coalescing_key); leader.has_value()) {
+            auto request = adopt_ref(*new Request(*this, nullptr));
+            request->m_method = method;
+            request->m_url = url;
+            request->m_request_headers = request_headers;
+            request->m_was_coalesced = true;
+            (*leader)->m_coalesced_requests.append(request);
+            did_coalesce_request();
+            return request;
+        }
+    }
+
+    auto request_or_error = create_request(m_session, method, url, request_headers, request_body, proxy, move(revalidating_entry));
     if (request_or_error.is_error()) {
         return nullptr;
     }
     auto request = request_or_error.release_value();
+
+    if (!coalescing_key.is_null()) {
+        request->m_request_headers = request_headers;
+        request->m_coalescing_key = coalescing_key;
+        m_in_flight_requests.set(move(coalescing_key), request.ptr());
+    }
+
+    if (initiator == Initiator::Speculative) {
+        // NOTE: Whatever the page really needs next must never wait behind a guess.
+        request->m_is_speculative = true;
+        request->m_priority = Ladybird::RequestScheduler::Priority::Low;
+        soup_message_set_priority(request->reply(), SOUP_MESSAGE_PRIORITY_LOW);
+    } else if (m_preload_scanner_enabled && m_http_cache && is_document_request(method, request_headers)) {
+        request->m_request_headers = request_headers;
+        request->m_preload_scanner = make<Ladybird::PreloadScanner>(url.serialize());
+        request->m_is_scanning_document = true;
+    }
+
+    if (is_cacheable || (m_http_cache && !method.is_one_of_ignoring_ascii_case("get"sv, "head"sv, "options"sv))) {
+        request->m_http_cache = m_http_cache.ptr();
+        if (is_cacheable)
+            request->m_request_headers = request_headers;
+    }
+
     m_pending.set(request->reply(), *request);
+    m_scheduler.schedule(request->m_priority, [this, request] {
+        request->hold_scheduler_slot();
+        send_request(*request);
+    });
     return request;
 }
 
-ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> RequestManagerSoup::create_request(SoupSession *session, DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&)
+Optional<RequestManagerSoup::SpeculativeRequest> RequestManagerSoup::take_speculative_request(DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    if (m_speculative_requests.is_empty() || !method.equals_ignoring_ascii_case("get"sv))
+        return {};
+
+    auto it = m_speculative_requests.find(url.serialize(AK::URL::ExcludeFragment::Yes));
+    if (it == m_speculative_requests.end())
+        return {};
+
+    auto speculation = move(it->value);
+    m_speculative_requests.remove(it);
+
+    auto has_expired = !speculation.in_flight && g_get_monotonic_time() - speculation.issue_time >= SPECULATIVE_REQUEST_LIFETIME;
+    if (has_expired || !credentials_match(speculation.request_headers, request_headers)) {
+        ++m_preload_statistics.wasted;
+        return {};
+    }
+    return speculation;
+}
+
+void RequestManagerSoup::expire_speculative_requests()
+{
+    auto now = g_get_monotonic_time();
+    m_speculative_requests.remove_all_matching([&](auto const&, auto const& speculation) {
+        if (speculation.in_flight || now - speculation.issue_time < SPECULATIVE_REQUEST_LIFETIME)
+            return false;
+        ++m_preload_statistics.wasted;
+        return true;
+    });
+}
+
+void RequestManagerSoup::start_speculative_request(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> request_headers)
+{
+    auto key = url.serialize(AK::URL::ExcludeFragment::Yes);
+    if (!m_http_cache || m_speculative_requests.size() >= MAX_SPECULATIVE_REQUESTS || m_speculative_requests.contains(key))
+        return;
+
+    if (auto lookup = m_http_cache->lookup(url, request_headers); lookup.has_value() && lookup->entry->is_fresh(Ladybird::HttpCache::current_time()))
+        return;
+
+    auto cache_time = Ladybird::HttpCache::current_time();
+    auto request = begin_request(Initiator::Speculative, "GET", url, request_headers, {}, {});
+    if (!request)
+        return;
+    request->on_buffered_request_finish = [](auto...) { };
+
+    // NOTE: This may have joined a request for the same thing, in which case the cache is all we can hope for.
+    m_speculative_requests.set(move(key), {
+        .in_flight = request->m_is_speculative ? request.ptr() : nullptr,
+        .request_headers = move(request_headers),
+        .issue_time = g_get_monotonic_time(),
+        .cache_time = cache_time,
+    });
+    ++m_preload_statistics.issued;
+}
+
+void RequestManagerSoup::start_speculative_requests(Request const& document, Vector<Ladybird::PreloadScanner::Resource> resources)
+{
+    expire_speculative_requests();
+
+    // NOTE: We only have the document's cookies to go by, so anything from elsewhere is left for LibWeb to ask for itself.
+    auto document_origin = document.m_url.serialize_origin();
+
+    for (auto& resource : resources) {
+        AK::URL url = resource.url;
+        if (!url.is_valid() || url.serialize_origin() != document_origin)
+            continue;
+
+        HashMap<DeprecatedString, DeprecatedString> request_headers;
+        request_headers.set("Accept", DeprecatedString { Ladybird::PreloadScanner::accept_header_for(resource.destination) });
+        for (auto name : { "User-Agent"sv, "Accept-Language"sv, "Cookie"sv }) {
+            if (auto value = find_request_header(document.m_request_headers, name); value.has_value())
+                request_headers.set(name, value.release_value());
+        }
+
+        start_speculative_request(url, move(request_headers));
+    }
+}
+
+void RequestManagerSoup::prefetch(AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv) || (m_archive && m_archive->is_replaying()))
+        return;
+
+    expire_speculative_requests();
+    start_speculative_request(url, request_headers);
+}
+
+void RequestManagerSoup::preconnect(AK::URL const& url)
+{
+    if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv) || (m_archive && m_archive->is_replaying()))
+        return;
+
+    auto now = g_get_monotonic_time();
+    m_recent_preconnects.remove_all_matching([&](auto const&, auto time) {
+        return now - time >= PRECONNECT_INTERVAL;
+    });
+
+    auto origin = url.serialize_origin();
+    if (m_recent_preconnects.contains(origin))
+        return;
+    m_recent_preconnects.set(move(origin), now);
+
+    char *c_url = owned_cstring_from_ak_string(url.to_string().value());
+    auto* message = soup_message_new(SOUP_METHOD_GET, c_url);
+    g_free(c_url);
+    if (!message)
+        return;
+
+    // NOTE: Connections are only handed to messages that want the same HTTP version, see create_request().
+    soup_message_set_force_http1(message, true);
+
+    run_on_network_thread([this, message] {
+        soup_session_preconnect_async(
+                m_session,
+                message,
+                G_PRIORITY_LOW,
+                nullptr,
+                [](GObject* source, GAsyncResult* result, gpointer user_data) {
+                    soup_session_preconnect_finish(SOUP_SESSION(source), result, nullptr);
+                    g_object_unref(user_data);
+                },
+                message);
+    });
+}
+
+void RequestManagerSoup::prefetch_dns(AK::URL const& url)
+{
+    if (!url.scheme().is_one_of_ignoring_ascii_case("http"sv, "https"sv) || (m_archive && m_archive->is_replaying()))
+        return;
+
+    char *c_url = owned_cstring_from_ak_string(url.to_string().value());
+    auto* uri = g_uri_parse(c_url, G_URI_FLAGS_NONE, nullptr);
+    g_free(c_url);
+    if (!uri)
+        return;
+
+    // NOTE: GLib doesn't cache lookups itself, so this only pays off with a caching system resolver. That's most desktops nowadays.
+    run_on_network_thread([host = g_strdup(g_uri_get_host(uri))] {
+        auto* resolver = g_resolver_get_default();
+        g_resolver_lookup_by_name_async(
+                resolver,
+                host,
+                nullptr,
+                [](GObject* source, GAsyncResult* result, gpointer) {
+                    g_resolver_free_addresses(g_resolver_lookup_by_name_finish(G_RESOLVER(source), result, nullptr));
+                },
+                nullptr);
+        g_object_unref(resolver);
+        g_free(host);
+    });
+    g_uri_unref(uri);
+}
+
+ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> RequestManagerSoup::create_request(SoupSession*, DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&, RefPtr<Ladybird::HttpCache::Entry> revalidating_entry)
 {
     SoupMessageHeaders *soup_request_headers;
     SoupMessage *msg;
@@ -51,24 +629,19 @@ ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> RequestManagerSoup::create_r
     } else if (method.equals_ignoring_ascii_case("post"sv)) {
         msg = soup_message_new (SOUP_METHOD_POST, c_url);
 
-        GBytes *request_bytes = g_bytes_new_static ((char const*)request_body.data(), request_body.size());
-        soup_message_set_request_body_from_bytes(msg, "application/octet-stream", request_bytes);
-        g_bytes_unref (request_bytes);
+        set_request_body(msg, Ladybird::RequestBody::create_from_bytes(request_body));
     } else if (method.equals_ignoring_ascii_case("put"sv)) {
         msg = soup_message_new (SOUP_METHOD_PUT, c_url);
 
-        GBytes *request_bytes = g_bytes_new_static ((char const*)request_body.data(), request_body.size());
-        soup_message_set_request_body_from_bytes(msg, "application/octet-stream", request_bytes);
-        g_bytes_unref (request_bytes);
+        set_request_body(msg, Ladybird::RequestBody::create_from_bytes(request_body));
     } else if (method.equals_ignoring_ascii_case("delete"sv)) {
         msg = soup_message_new (SOUP_METHOD_DELETE, c_url);
     } else {
         // Custom e.g. for HTTP OPTIONS
         // Do we need this?
         msg = soup_message_new (method.characters(), c_url);
-        GBytes *request_bytes = g_bytes_new_static ((char const*)request_body.data(), request_body.size());
-        soup_message_set_request_body_from_bytes(msg, "application/octet-stream", request_bytes);
-        g_bytes_unref (request_bytes);
+        if (!request_body.is_empty())
+            set_request_body(msg, Ladybird::RequestBody::create_from_bytes(request_body));
     }
 
     g_free(c_url);
@@ -76,69 +649,551 @@ ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> RequestManagerSoup::create_r
     soup_request_headers = soup_message_get_request_headers(msg);
 
     for (auto& it : request_headers) {
+        // NOTE: Content codings are negotiated (and decoded) by libsoup, not by the page.
         if (g_ascii_strcasecmp(it.key.characters(), "Accept-Encoding") == 0)
             continue;
         soup_message_headers_append(soup_request_headers, it.key.characters(), it.value.characters());
     }
 
+    if (revalidating_entry) {
+        if (!revalidating_entry->etag().is_null())
+            soup_message_headers_replace(soup_request_headers, "If-None-Match", revalidating_entry->etag().characters());
+        if (!revalidating_entry->last_modified().is_null())
+            soup_message_headers_replace(soup_request_headers, "If-Modified-Since", revalidating_entry->last_modified().characters());
+    }
+
     /* NOTE: We explicitly disable HTTP2 as it's significantly slower (up to 5x, possibly more) */
     soup_message_set_force_http1 (msg, true);
+    soup_message_add_flags (msg, SOUP_MESSAGE_COLLECT_METRICS);
 
-    soup_session_send_and_read_async (
-            session,
-            msg,
-            G_PRIORITY_DEFAULT,
-            nullptr,
-            reinterpret_cast<GAsyncReadyCallback>(reply_finished),
-            this);
+#ifdef HAVE_ZSTD
+    g_signal_connect (msg, "starting", G_CALLBACK (message_starting), nullptr);
+#endif
+
+    auto priority = priority_for_request(method, url, request_headers);
+    soup_message_set_priority (msg, soup_priority_for(priority));
+
+    auto request = adopt_ref (*new Request(*this, msg));
+    request->m_method = method;
+    request->m_url = url;
+    request->m_revalidating_entry = move(revalidating_entry);
+    request->m_priority = priority;
+
+    if (auto upload_size = soup_message_headers_get_content_length(soup_request_headers); upload_size > 0) {
+        request->m_upload_size = upload_size;
+        g_signal_connect (msg, "wrote-body-data", G_CALLBACK (Request::did_write_body_data), request.ptr());
+    }
+
+    g_signal_connect (msg, "network-event", G_CALLBACK (Request::did_receive_network_event), request.ptr());
+
+    return request;
+}
 
-    return adopt_ref (*new Request(msg));
+bool RequestManagerSoup::should_emulate_failure() const
+{
+    if (m_network_conditions.failure_rate <= 0)
+        return false;
+    return get_random_uniform(1'000'000) < m_network_conditions.failure_rate * 1'000'000;
 }
 
-RequestManagerSoup::Request::Request(SoupMessage *reply)
-    : m_reply(reply)
+void RequestManagerSoup::send_request(Request& request)
 {
+    if (!m_network_conditions.is_enabled()) {
+        send_request_now(request);
+        return;
+    }
+
+    // NOTE: libsoup pulls request bodies itself and can't be paused, so the upload limit holds the request back
+    //       for as long as its body would have taken to get through instead.
+    auto delay = static_cast<i64>(m_network_conditions.latency_ms) * 1000 + m_upload_bucket.consume(request.m_upload_size);
+    auto should_fail = should_emulate_failure();
+
+    invoke_after(delay, [this, request = NonnullRefPtr(request), should_fail] {
+        if (should_fail) {
+            request->did_fail(g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED, "Emulated network failure"));
+            return;
+        }
+        send_request_now(*request);
+    });
 }
 
-RequestManagerSoup::Request::~Request() = default;
+void RequestManagerSoup::send_request_now(Request& request)
+{
+    request.m_request_time = Ladybird::HttpCache::current_time();
+
+    run_on_network_thread([this, request = &request] {
+        soup_session_send_async (
+                m_session,
+                request->reply(),
+                request->io_priority(),
+                nullptr,
+                reinterpret_cast<GAsyncReadyCallback>(reply_received),
+                request);
+    });
+}
+
+NonnullRefPtr<RequestManagerSoup::Request> RequestManagerSoup::replay_request(DeprecatedString const& method, AK::URL const& url)
+{
+    auto request = adopt_ref(*new Request(*this, nullptr));
+    request->m_method = method;
+    request->m_url = url;
+
+    auto record = m_archive->find(method, url);
+    if (!record.has_value())
+        dbgln("No archived response for {} {}", method, url);
+
+    // NOTE: Like cache hits, this must not finish before LibWeb has had a chance to hook up its callbacks.
+    auto delay = record.has_value() && m_replays_original_latency ? record->duration : 0;
+    invoke_after(delay, [request, record = move(record)] {
+        request->did_finish_from_archive(record);
+    });
+    return request;
+}
+
+RequestManagerSoup::Request::Request(RequestManagerSoup& manager, SoupMessage *reply)
+    : m_manager(manager)
+    , m_reply(reply)
+    , m_queued_time(g_get_monotonic_time())
+    , m_start_time(g_get_real_time())
+{
+}
+
+RequestManagerSoup::Request::~Request()
+{
+    // NOTE: Only still set if the manager is going away with this request in flight.
+    if (m_scheduler_slot_timeout)
+        g_source_remove(m_scheduler_slot_timeout);
+    if (m_stream)
+        g_object_unref(m_stream);
+    if (m_body)
+        g_byte_array_unref(m_body);
+}
 
-void RequestManagerSoup::Request::did_finish(SoupSession *session, SoupMessage *reply, GAsyncResult *result)
+void RequestManagerSoup::Request::did_receive_response(SoupSession *session, GAsyncResult *result)
 {
     GError *error = nullptr;
-    GBytes *buffer = soup_session_send_and_read_finish(session, result, &error);
+    GInputStream *stream = soup_session_send_finish(session, result, &error);
 
     if (error) {
-        dbgln("Request Error: {}", error->message);
-        g_error_free(error);
+        m_manager.run_on_main_thread([this, error] { did_fail(error); });
+        return;
+    }
+
+    auto http_response_headers = soup_message_get_response_headers(m_reply);
+
+#ifdef HAVE_ZSTD
+    if (is_zstd_encoded(http_response_headers)) {
+        GConverter *decompressor = web_zstd_decompressor_new();
+        GInputStream *decoded_stream = g_converter_input_stream_new(stream, decompressor);
+        g_object_unref(decompressor);
+        g_object_unref(stream);
+        stream = decoded_stream;
+    }
+#endif
+
+    m_stream = stream;
+
+    if (m_is_scanning_document) {
+        auto const* content_type = soup_message_headers_get_content_type(http_response_headers, nullptr);
+        m_is_scanning_document = content_type && g_ascii_strcasecmp(content_type, "text/html") == 0;
+    }
+
+    // NOTE: Content-Length describes the body as it went over the wire, which is only the size we end up with if nothing was decoded.
+    auto content_length = soup_message_headers_get_content_length(http_response_headers);
+    if (content_length > 0 && content_length <= NumericLimits<u32>::max() && !soup_message_headers_get_one(http_response_headers, "Content-Encoding"))
+        m_total_size = static_cast<u32>(content_length);
+
+    m_body = g_byte_array_sized_new(m_total_size.value_or(READ_CHUNK_SIZE));
+    read_next_chunk();
+}
+
+void RequestManagerSoup::Request::read_next_chunk()
+{
+    auto offset = m_body->len;
+    g_byte_array_set_size(m_body, offset + READ_CHUNK_SIZE);
+
+    g_input_stream_read_async(
+            m_stream,
+            m_body->data + offset,
+            READ_CHUNK_SIZE,
+            io_priority(),
+            nullptr,
+            did_read_chunk,
+            this);
+}
+
+void RequestManagerSoup::Request::did_read_chunk(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    auto& request = *static_cast<Request *>(user_data);
+
+    GError *error = nullptr;
+    auto bytes_read = g_input_stream_read_finish(G_INPUT_STREAM(source), result, &error);
+
+    if (error || bytes_read == 0) {
+        // NOTE: Let go of the stream here, as closing it hands the connection back to the session on this thread.
+        g_clear_object(&request.m_stream);
+
+        if (error) {
+            request.m_manager.run_on_main_thread([&request, error] { request.did_fail(error); });
+            return;
+        }
+
+        g_byte_array_set_size(request.m_body, request.m_body->len - READ_CHUNK_SIZE);
+        request.m_manager.run_on_main_thread([&request] { request.did_finish_reading(); });
+        return;
+    }
+
+    g_byte_array_set_size(request.m_body, request.m_body->len - READ_CHUNK_SIZE + bytes_read);
+
+    if (request.m_is_scanning_document) {
+        auto resources = request.m_preload_scanner->feed({ request.m_body->data + request.m_body->len - bytes_read, static_cast<size_t>(bytes_read) });
+        request.m_is_scanning_document = !request.m_preload_scanner->is_done();
+        if (!resources.is_empty()) {
+            request.m_manager.run_on_main_thread([&request, resources = move(resources)]() mutable {
+                request.m_manager.start_speculative_requests(request, move(resources));
+            });
+        }
+    }
+
+    // NOTE: The callbacks are set on the main thread, possibly after the request started, so only look at them there.
+    request.m_manager.run_on_main_thread([&request, total_size = request.m_total_size, downloaded = request.m_body->len] {
+        if (request.on_progress)
+            request.on_progress(total_size, downloaded);
+    });
+
+    // NOTE: Holding off the next read lets the socket buffers fill up, so the server really does get slowed down too.
+    if (auto delay = request.m_manager.m_download_bucket.consume(bytes_read); delay > 0) {
+        invoke_after(delay, [&request] {
+            request.read_next_chunk();
+        });
+        return;
+    }
+
+    request.read_next_chunk();
+}
+
+void RequestManagerSoup::Request::did_write_body_data(SoupMessage*, guint chunk_size, gpointer user_data)
+{
+    auto& request = *static_cast<Request *>(user_data);
+    request.m_uploaded += chunk_size;
+
+    // NOTE: libsoup writes in fairly small chunks, so only report every percent or so.
+    auto reporting_interval = max<u64>(request.m_upload_size / 100, 64 * KiB);
+    if (request.m_uploaded < request.m_upload_size && request.m_uploaded - request.m_last_reported_upload < reporting_interval)
+        return;
+
+    request.m_last_reported_upload = request.m_uploaded;
+    request.m_manager.run_on_main_thread([&request, uploaded = request.m_uploaded] {
+        if (request.on_upload_progress)
+            request.on_upload_progress(uploaded, request.m_upload_size);
+        else if (request.m_manager.on_upload_progress)
+            request.m_manager.on_upload_progress(request.m_url, uploaded, request.m_upload_size);
+    });
+}
+
+// NOTE: libsoup hands out connections per SoupSession, and GIO keeps TLS sessions to itself. The one way to carry a session over
+//       to a new connection is copying it from one that's done with its handshake, so keep the last of those for every origin.
+// NOTE: This only lasts as long as the process does. GIO has no way to export session state, so there's nothing to persist,
+//       and so no setting for it either.
+void RequestManagerSoup::Request::did_receive_network_event(SoupMessage *message, GSocketClientEvent event, GIOStream *connection, gpointer user_data)
+{
+    if (!G_IS_TLS_CLIENT_CONNECTION(connection))
         return;
+
+    auto& request = *static_cast<Request *>(user_data);
+    auto& sessions = request.m_manager.m_tls_sessions;
+
+    auto* uri = soup_message_get_uri(message);
+    auto origin = DeprecatedString::formatted("{}://{}:{}", g_uri_get_scheme(uri), g_uri_get_host(uri), g_uri_get_port(uri));
+
+    switch (event) {
+    case G_SOCKET_CLIENT_TLS_HANDSHAKING: {
+        // NOTE: Some versions of glib-networking only resume sessions when asked to.
+        if (g_object_class_find_property(G_OBJECT_GET_CLASS(connection), "session-resumption-enabled"))
+            g_object_set(connection, "session-resumption-enabled", TRUE, nullptr);
+
+        if (auto it = sessions.find(origin); it != sessions.end() && g_get_monotonic_time() - it->value.time < TLS_SESSION_LIFETIME) {
+            g_tls_client_connection_copy_session_state(G_TLS_CLIENT_CONNECTION(connection), it->value.connection);
+            request.m_offered_tls_session = true;
+        }
+        break;
+    }
+    case G_SOCKET_CLIENT_TLS_HANDSHAKED: {
+        if (g_object_class_find_property(G_OBJECT_GET_CLASS(connection), "session-resumed")) {
+            gboolean resumed = FALSE;
+            g_object_get(connection, "session-resumed", &resumed, nullptr);
+            request.m_resumed_tls_session = resumed;
+        }
+
+        auto now = g_get_monotonic_time();
+        sessions.remove_all_matching([&](auto const& session_origin, auto const& session) {
+            if (session_origin != origin && now - session.time < TLS_SESSION_LIFETIME)
+                return false;
+            g_object_unref(session.connection);
+            return true;
+        });
+
+        if (sessions.size() >= MAX_TLS_SESSIONS) {
+            auto oldest = sessions.begin();
+            for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+                if (it->value.time < oldest->value.time)
+                    oldest = it;
+            }
+            g_object_unref(oldest->value.connection);
+            sessions.remove(oldest);
+        }
+        sessions.set(move(origin), { G_TLS_CLIENT_CONNECTION(g_object_ref(connection)), now });
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static StringView http_version_string(SoupHTTPVersion version)
+{
+    switch (version) {
+    case SOUP_HTTP_1_0:
+        return "HTTP/1.0"sv;
+    case SOUP_HTTP_1_1:
+        return "HTTP/1.1"sv;
+    case SOUP_HTTP_2_0:
+        return "HTTP/2.0"sv;
+    default:
+        return "unknown"sv;
+    }
+}
+
+void RequestManagerSoup::Request::record_network_timing(u64 decoded_body_size)
+{
+    auto finish_time = g_get_monotonic_time();
+
+    Ladybird::RequestTiming timing;
+    timing.method = m_method;
+    timing.url = m_url.to_deprecated_string();
+    timing.status_code = soup_message_get_status(m_reply);
+    timing.http_version = http_version_string(soup_message_get_http_version(m_reply));
+    if (auto const* content_type = soup_message_headers_get_one(soup_message_get_response_headers(m_reply), "Content-Type"))
+        timing.mime_type = content_type;
+    timing.start_time = m_start_time;
+    timing.decoded_body_size = decoded_body_size;
+
+    // NOTE: libsoup's metrics are on the same monotonic clock as g_get_monotonic_time(), and are 0 for anything that didn't happen.
+    if (auto* metrics = soup_message_get_metrics(m_reply)) {
+        auto phase = [](guint64 start, guint64 end) -> i64 {
+            if (!start || !end || end < start)
+                return -1;
+            return static_cast<i64>(end - start);
+        };
+
+        auto dns_start = soup_message_metrics_get_dns_start(metrics);
+        auto connect_start = soup_message_metrics_get_connect_start(metrics);
+        auto connect_end = soup_message_metrics_get_connect_end(metrics);
+        auto request_start = soup_message_metrics_get_request_start(metrics);
+        auto response_start = soup_message_metrics_get_response_start(metrics);
+
+        // Time spent in our scheduler's queue and libsoup's, up until the first thing happened on the wire.
+        auto first_activity = dns_start ? dns_start : connect_start ? connect_start : request_start;
+        if (first_activity)
+            timing.blocked = max<i64>(0, static_cast<i64>(first_activity) - m_queued_time);
+
+        timing.dns = phase(dns_start, soup_message_metrics_get_dns_end(metrics));
+        timing.connect = phase(connect_start, connect_end);
+        timing.tls = phase(soup_message_metrics_get_tls_start(metrics), connect_end);
+
+        // libsoup doesn't note when the request has been written, so that's all part of waiting.
+        timing.send = request_start ? 0 : -1;
+        timing.wait = phase(request_start, response_start);
+        timing.receive = phase(response_start, static_cast<guint64>(finish_time));
+
+        timing.request_header_size = soup_message_metrics_get_request_header_bytes_sent(metrics);
+        timing.request_body_size = soup_message_metrics_get_request_body_bytes_sent(metrics);
+        timing.response_header_size = soup_message_metrics_get_response_header_bytes_received(metrics);
+        timing.response_body_size = soup_message_metrics_get_response_body_bytes_received(metrics);
     }
 
-    auto http_status_code = soup_message_get_status(reply);
-    auto http_response_headers = soup_message_get_response_headers(reply);
-    HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> response_headers;
-    Vector<DeprecatedString> set_cookie_headers;
+    if (timing.tls >= 0) {
+        auto& statistics = m_manager.m_tls_statistics;
+        ++statistics.handshakes;
+        statistics.handshake_time += timing.tls;
+        if (m_offered_tls_session)
+            ++statistics.resumption_attempts;
+        if (m_resumed_tls_session)
+            ++statistics.resumed;
+    }
 
-    SoupMessageHeadersIter iter;
-    const char *c_name, *c_value;
+    m_timing = timing;
+    m_manager.record_timing(move(timing));
+}
+
+void RequestManagerSoup::Request::hold_scheduler_slot()
+{
+    VERIFY(!m_holds_scheduler_slot);
+    m_holds_scheduler_slot = true;
+    m_scheduler_slot_timeout = g_timeout_add(SCHEDULER_SLOT_TIMEOUT_MS, [](gpointer user_data) -> gboolean {
+        auto& request = *static_cast<Request*>(user_data);
+        request.m_scheduler_slot_timeout = 0;
+        request.release_scheduler_slot();
+        return G_SOURCE_REMOVE;
+    }, this);
+}
+
+void RequestManagerSoup::Request::release_scheduler_slot()
+{
+    if (!m_holds_scheduler_slot)
+        return;
+    m_holds_scheduler_slot = false;
+    if (m_scheduler_slot_timeout) {
+        g_source_remove(m_scheduler_slot_timeout);
+        m_scheduler_slot_timeout = 0;
+    }
+    m_manager.m_scheduler.did_finish(m_priority);
+}
+
+void RequestManagerSoup::Request::did_fail(GError *error)
+{
+    NonnullRefPtr protect = *this;
+    m_manager.m_pending.remove(m_reply);
+    release_scheduler_slot();
 
-    soup_message_headers_iter_init(&iter, http_response_headers);
-    while (soup_message_headers_iter_next(&iter, &c_name, &c_value))
-    {
-        auto name = DeprecatedString(c_name);
-        auto value = DeprecatedString(c_value);
-        if (name.equals_ignoring_ascii_case("set-cookie"sv)) {
-            set_cookie_headers.append(value);
-        } else {
-            response_headers.set(name, value);
+    dbgln("Request Error: {}", error->message);
+    g_error_free(error);
+
+    auto coalesced_requests = take_coalesced_requests();
+    record_network_timing(0);
+    on_buffered_request_finish(false, 0, {}, {}, {});
+    finish_coalesced_requests(move(coalesced_requests), false, {}, {}, {});
+}
+
+Vector<NonnullRefPtr<RequestManagerSoup::Request>> RequestManagerSoup::Request::take_coalesced_requests()
+{
+    // NOTE: Stop taking on more requests before anyone hears back, as LibWeb might well ask for the same thing again from its callback.
+    if (!m_coalescing_key.is_null()) {
+        m_manager.m_in_flight_requests.remove(m_coalescing_key);
+        m_coalescing_key = {};
+    }
+    if (m_is_speculative) {
+        auto it = m_manager.m_speculative_requests.find(m_url.serialize(AK::URL::ExcludeFragment::Yes));
+        if (it != m_manager.m_speculative_requests.end() && it->value.in_flight == this)
+            it->value.in_flight = nullptr;
+        m_is_speculative = false;
+    }
+    return move(m_coalesced_requests);
+}
+
+void RequestManagerSoup::Request::finish_coalesced_requests(Vector<NonnullRefPtr<Request>> requests, bool success, Ladybird::HttpCache::HeaderMap const& response_headers, Optional<u32> status_code, ReadonlyBytes body)
+{
+    for (auto& request : requests) {
+        if (!success || varied_headers_match(response_headers, m_request_headers, request->m_request_headers)) {
+            request->on_buffered_request_finish(success, body.size(), response_headers, status_code, body);
+            continue;
         }
+
+        // The response turned out to depend on something these requests disagree on, so this one needs its own.
+        auto retry = m_manager.start_request(request->m_method, request->m_url, request->m_request_headers, {}, {});
+        if (!retry) {
+            request->on_buffered_request_finish(false, 0, {}, {}, {});
+            continue;
+        }
+        retry->on_buffered_request_finish = [request](bool success, auto total_size, auto const& response_headers, auto status_code, ReadonlyBytes payload) {
+            request->on_buffered_request_finish(success, total_size, response_headers, status_code, payload);
+        };
     }
+}
+
+void RequestManagerSoup::Request::did_finish_reading()
+{
+    NonnullRefPtr protect = *this;
+    m_manager.m_pending.remove(m_reply);
+    release_scheduler_slot();
 
-    if (!set_cookie_headers.is_empty()) {
-        response_headers.set("set-cookie"sv, JsonArray { set_cookie_headers }.to_deprecated_string());
+    GBytes *buffer = g_byte_array_free_to_bytes(m_body);
+    m_body = nullptr;
+
+    auto http_status_code = soup_message_get_status(m_reply);
+    auto http_response_headers = soup_message_get_response_headers(m_reply);
+
+    record_network_timing(g_bytes_get_size(buffer));
+
+    if (m_manager.m_archive && m_manager.m_archive->is_recording() && http_status_code != 0) {
+        gsize size;
+        auto const* data = static_cast<u8 const*>(g_bytes_get_data(buffer, &size));
+        auto duration = g_get_monotonic_time() - m_queued_time;
+        if (auto result = m_manager.m_archive->record(m_method, m_url, http_status_code, http_response_headers, { data, size }, duration); result.is_error())
+            dbgln("Unable to record {} in network archive: {}", m_url, result.error());
     }
+
+    if (m_http_cache) {
+        auto response_time = Ladybird::HttpCache::current_time();
+
+        if (http_status_code == SOUP_STATUS_NOT_MODIFIED && m_revalidating_entry) {
+            auto entry = m_http_cache->freshen(m_url, *m_revalidating_entry, http_response_headers, m_request_time, response_time);
+            g_bytes_unref(buffer);
+            did_finish_from_cache(*entry);
+            return;
+        }
+
+        if (m_method.equals_ignoring_ascii_case("get"sv)) {
+            m_http_cache->store(m_url, m_request_headers, http_status_code, http_response_headers, buffer, m_request_time, response_time);
+        } else if (http_status_code >= 200 && http_status_code < 400) {
+            m_http_cache->invalidate(m_url);
+        }
+    }
+
+    auto response_headers = Ladybird::header_map_from_soup(http_response_headers);
+    auto coalesced_requests = take_coalesced_requests();
+
     bool success = http_status_code != 0;
     gsize buffer_length;
     auto buffer_data = g_bytes_get_data(buffer, &buffer_length);
-    on_buffered_request_finish(success, buffer_length, response_headers, http_status_code, ReadonlyBytes { buffer_data, (size_t)buffer_length });
+    ReadonlyBytes body { buffer_data, (size_t)buffer_length };
+    on_buffered_request_finish(success, buffer_length, response_headers, http_status_code, body);
+    finish_coalesced_requests(move(coalesced_requests), success, response_headers, http_status_code, body);
     g_bytes_unref(buffer);
 }
+
+void RequestManagerSoup::Request::did_finish_from_cache(Ladybird::HttpCache::Entry const& entry)
+{
+    // NOTE: Revalidated responses have already been timed as the network requests they were.
+    if (!m_reply) {
+        Ladybird::RequestTiming timing;
+        timing.method = m_method;
+        timing.url = m_url.to_deprecated_string();
+        timing.status_code = entry.status_code();
+        timing.mime_type = entry.header("Content-Type"sv).value_or({});
+        timing.from_cache = true;
+        timing.start_time = m_start_time;
+        timing.blocked = 0;
+        timing.send = 0;
+        timing.wait = 0;
+        timing.receive = g_get_monotonic_time() - m_queued_time;
+        timing.decoded_body_size = entry.body_size();
+        m_timing = timing;
+        m_manager.record_timing(move(timing));
+    }
+
+    auto coalesced_requests = take_coalesced_requests();
+
+    gsize buffer_length;
+    auto buffer_data = g_bytes_get_data(entry.body(), &buffer_length);
+    ReadonlyBytes body { buffer_data, (size_t)buffer_length };
+    on_buffered_request_finish(true, buffer_length, entry.header_map(), entry.status_code(), body);
+    finish_coalesced_requests(move(coalesced_requests), true, entry.header_map(), entry.status_code(), body);
+}
+
+void RequestManagerSoup::Request::did_finish_from_archive(Optional<Ladybird::NetworkArchive::Record> const& record)
+{
+    if (!record.has_value()) {
+        on_buffered_request_finish(false, 0, {}, {}, {});
+        return;
+    }
+
+    // NOTE: Go through SoupMessageHeaders, so replayed headers reach LibWeb exactly as live ones would.
+    auto* soup_headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    for (auto const& header : record->response_headers)
+        soup_message_headers_append(soup_headers, header.name.characters(), header.value.characters());
+    auto response_headers = Ladybird::header_map_from_soup(soup_headers);
+    soup_message_headers_unref(soup_headers);
+
+    on_buffered_request_finish(true, record->body.size(), response_headers, record->status_code, record->body);
+}
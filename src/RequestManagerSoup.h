@@ -7,28 +7,39 @@
 
 #pragma once
 
-#include <LibWeb/Loader/ResourceLoader.h>
+#include "HttpCache.h"
+#include "NetworkArchive.h"
+#include "NetworkThread.h"
+#include "NetworkSettings.h"
+#include "PreloadScanner.h"
+#include "RequestManager.h"
+#include "RequestScheduler.h"
 #include <glibmm/object.h>
 #include <libsoup/soup.h>
 
 class RequestManagerSoup
     : Glib::Object
-    , public Web::ResourceLoaderConnector {
+    , public Ladybird::RequestManager {
 public:
-    static NonnullRefPtr<RequestManagerSoup> create()
+    static NonnullRefPtr<RequestManagerSoup> create(Ladybird::NetworkSettings const& settings = {})
     {
-        return adopt_ref(*new RequestManagerSoup());
+        return adopt_ref(*new RequestManagerSoup(settings));
     }
 
-    virtual ~RequestManagerSoup() override { }
+    virtual ~RequestManagerSoup() override;
 
-    virtual void prefetch_dns(AK::URL const&) override { }
-    virtual void preconnect(AK::URL const&) override { }
+    virtual void prefetch_dns(AK::URL const&) override;
+    virtual void preconnect(AK::URL const&) override;
 
     virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(DeprecatedString const& method, AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&) override;
 
-private:
-    RequestManagerSoup();
+    virtual Optional<Ladybird::HttpCache::Statistics> http_cache_statistics() override;
+    virtual void set_network_conditions(Ladybird::NetworkConditions const&) override;
+    virtual void prefetch(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers) override;
+    virtual Ladybird::PreloadScanner::Statistics preload_statistics() override { return m_preload_statistics; }
+    virtual Ladybird::TlsStatistics tls_statistics() override { return m_tls_statistics; }
+
+    Ladybird::HttpCache* http_cache() { return m_http_cache.ptr(); }
 
     class Request
         : public Web::ResourceLoaderConnectorRequest {
@@ -40,19 +51,140 @@ private:
         virtual bool stop() override { return false; }
         virtual void stream_into(Stream&) override { }
 
-        void did_finish(SoupSession *session, SoupMessage *reply, GAsyncResult *result);
+        void did_receive_response(SoupSession *session, GAsyncResult *result);
+        void did_finish_from_cache(Ladybird::HttpCache::Entry const&);
+        void did_finish_from_archive(Optional<Ladybird::NetworkArchive::Record> const&);
 
         SoupMessage *reply() { return m_reply; }
+        int io_priority() const;
+
+        // Only available once the request has finished.
+        Optional<Ladybird::RequestTiming> const& timing() const { return m_timing; }
+
+        // Whether this request was answered by another, identical one that was already in flight.
+        bool was_coalesced() const { return m_was_coalesced; }
+
+        // NOTE: When unset, progress goes to the manager's on_upload_progress instead.
+        Function<void(u64 bytes_sent, u64 total_bytes)> on_upload_progress;
 
     private:
-        explicit Request(SoupMessage *message);
+        Request(RequestManagerSoup&, SoupMessage *message);
+
+        void read_next_chunk();
+        static void did_read_chunk(GObject *source, GAsyncResult *result, gpointer user_data);
+        static void did_write_body_data(SoupMessage *message, guint chunk_size, gpointer user_data);
+        static void did_receive_network_event(SoupMessage *message, GSocketClientEvent event, GIOStream *connection, gpointer user_data);
+        void did_finish_reading();
+        void did_fail(GError *error);
+        void hold_scheduler_slot();
+        void release_scheduler_slot();
+        void record_network_timing(u64 decoded_body_size);
+        Vector<NonnullRefPtr<Request>> take_coalesced_requests();
+        void finish_coalesced_requests(Vector<NonnullRefPtr<Request>>, bool success, Ladybird::HttpCache::HeaderMap const& response_headers, Optional<u32> status_code, ReadonlyBytes body);
 
+        RequestManagerSoup& m_manager;
         SoupMessage *m_reply;
+
+        // NOTE: This is the decoded body stream, so everything we read is what LibWeb gets to see.
+        GInputStream *m_stream { nullptr };
+        GByteArray *m_body { nullptr };
+        Optional<u32> m_total_size;
+        Ladybird::RequestScheduler::Priority m_priority { Ladybird::RequestScheduler::Priority::Normal };
+        bool m_holds_scheduler_slot { false };
+        // NOTE: Keeps a pointer to the request, which is fine as m_pending keeps it alive for at least as long as it holds its slot.
+        guint m_scheduler_slot_timeout { 0 };
+        DeprecatedString m_method;
+        AK::URL m_url;
+
+        i64 m_queued_time { 0 };
+        i64 m_start_time { 0 };
+        Optional<Ladybird::RequestTiming> m_timing;
+
+        u64 m_upload_size { 0 };
+        u64 m_uploaded { 0 };
+        u64 m_last_reported_upload { 0 };
+
+        // Only set for requests the HTTP cache is interested in.
+        Ladybird::HttpCache* m_http_cache { nullptr };
+        HashMap<DeprecatedString, DeprecatedString> m_request_headers;
+        RefPtr<Ladybird::HttpCache::Entry> m_revalidating_entry;
+        i64 m_request_time { 0 };
+
+        // Set while this request is the one in flight for others like it.
+        DeprecatedString m_coalescing_key;
+        Vector<NonnullRefPtr<Request>> m_coalesced_requests;
+        bool m_was_coalesced { false };
+
+        // NOTE: Created on the main thread, but only ever fed from the thread the body is read on.
+        OwnPtr<Ladybird::PreloadScanner> m_preload_scanner;
+        bool m_is_scanning_document { false };
+        bool m_is_speculative { false };
+
+        bool m_offered_tls_session { false };
+        bool m_resumed_tls_session { false };
+    };
+
+private:
+    explicit RequestManagerSoup(Ladybird::NetworkSettings const&);
+
+    enum class Initiator {
+        Page,
+        Speculative,
+    };
+
+    struct SpeculativeRequest {
+        // Cleared once the response is in, from then on it's up to the HTTP cache.
+        Request* in_flight { nullptr };
+        HashMap<DeprecatedString, DeprecatedString> request_headers;
+        i64 issue_time { 0 };
+        // On the HTTP cache's clock, so the entry this request stored can be told apart from older ones.
+        i64 cache_time { 0 };
     };
 
-    ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> create_request(SoupSession *session, DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
-    static void reply_finished(SoupSession* session, GAsyncResult* result, gpointer);
+    RefPtr<Request> begin_request(Initiator, DeprecatedString const& method, AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
+    Optional<SpeculativeRequest> take_speculative_request(DeprecatedString const& method, AK::URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers);
+    void expire_speculative_requests();
+    void start_speculative_request(AK::URL const&, HashMap<DeprecatedString, DeprecatedString> request_headers);
+    void start_speculative_requests(Request const& document, Vector<Ladybird::PreloadScanner::Resource>);
+
+    ErrorOr<NonnullRefPtr<RequestManagerSoup::Request>> create_request(SoupSession *session, DeprecatedString const& method, AK::URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&, RefPtr<Ladybird::HttpCache::Entry> revalidating_entry);
+    void send_request(Request&);
+    void send_request_now(Request&);
+    void run_on_network_thread(Function<void()>);
+    void run_on_main_thread(Function<void()>);
+    bool should_emulate_failure() const;
+    NonnullRefPtr<Request> replay_request(DeprecatedString const& method, AK::URL const& url);
+    static void reply_received(SoupSession* session, GAsyncResult* result, gpointer);
+#ifdef HAVE_ZSTD
+    static void message_starting(SoupMessage* message, gpointer);
+#endif
 
     HashMap<SoupMessage*, NonnullRefPtr<Request>> m_pending;
+    OwnPtr<Ladybird::NetworkThread> m_network_thread;
     SoupSession* m_session;
+    Ladybird::RequestScheduler m_scheduler;
+    OwnPtr<Ladybird::HttpCache> m_http_cache;
+    HashMap<DeprecatedString, Request*> m_in_flight_requests;
+    OwnPtr<Ladybird::NetworkArchive> m_archive;
+    bool m_replays_original_latency { true };
+
+    bool m_preload_scanner_enabled { true };
+    HashMap<DeprecatedString, SpeculativeRequest> m_speculative_requests;
+    Ladybird::PreloadScanner::Statistics m_preload_statistics;
+    HashMap<DeprecatedString, i64> m_recent_preconnects;
+
+    // The last connection to finish a handshake with each origin, to resume its session from.
+    // NOTE: Only touched from the network thread, as that's where handshakes happen.
+    struct TlsSession {
+        GTlsClientConnection* connection { nullptr };
+        i64 time { 0 };
+    };
+    HashMap<DeprecatedString, TlsSession> m_tls_sessions;
+    Ladybird::TlsStatistics m_tls_statistics;
+
+    Ladybird::NetworkConditions m_network_conditions;
+    // NOTE: Only touched from the main thread, as that's where requests are held back before they're sent.
+    Ladybird::TokenBucket m_upload_bucket;
+    // NOTE: Only touched from the network thread, as that's where bodies are read.
+    Ladybird::TokenBucket m_download_bucket;
 };
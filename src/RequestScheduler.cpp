@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RequestScheduler.h"
+
+namespace Ladybird {
+
+static constexpr u32 slots_reserved_for_render_blocking = 2;
+
+RequestScheduler::RequestScheduler(u32 max_in_flight)
+    : m_max_in_flight(max(max_in_flight, 1u))
+{
+}
+
+void RequestScheduler::schedule(Priority priority, Function<void()> start)
+{
+    m_pending[to_underlying(priority)].enqueue(move(start));
+    start_pending();
+}
+
+void RequestScheduler::did_finish(Priority priority)
+{
+    VERIFY(m_in_flight[to_underlying(priority)] > 0);
+    --m_in_flight[to_underlying(priority)];
+    --m_in_flight_total;
+    start_pending();
+}
+
+bool RequestScheduler::can_start(Priority priority) const
+{
+    if (m_in_flight_total >= m_max_in_flight)
+        return false;
+    if (priority == Priority::RenderBlocking)
+        return true;
+
+    // Everything else leaves a few slots open, unless the limit is too small for that to make sense.
+    auto reserved = m_max_in_flight > slots_reserved_for_render_blocking * 2 ? slots_reserved_for_render_blocking : 0;
+    if (m_in_flight_total >= m_max_in_flight - reserved)
+        return false;
+
+    // While render-blocking resources are still outstanding, low priority ones only get half of what's left.
+    if (priority == Priority::Low) {
+        auto render_blocking = to_underlying(Priority::RenderBlocking);
+        if (m_in_flight[render_blocking] > 0 || !m_pending[render_blocking].is_empty())
+            return m_in_flight[to_underlying(Priority::Low)] < (m_max_in_flight - reserved) / 2;
+    }
+
+    return true;
+}
+
+void RequestScheduler::start_pending()
+{
+    for (size_t i = 0; i < priority_count; ++i) {
+        auto priority = static_cast<Priority>(i);
+        while (!m_pending[i].is_empty() && can_start(priority)) {
+            auto start = m_pending[i].dequeue();
+            ++m_in_flight[i];
+            ++m_in_flight_total;
+            start();
+        }
+        // NOTE: Don't let lower priorities overtake a queue that's merely waiting for a slot.
+        if (!m_pending[i].is_empty() && m_in_flight_total >= m_max_in_flight)
+            return;
+    }
+}
+
+}
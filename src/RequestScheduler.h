@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Function.h>
+#include <AK/Queue.h>
+#include <AK/Types.h>
+
+namespace Ladybird {
+
+// Decides which network requests get to go out next.
+// libsoup queues by message priority too, but only once it runs out of connections. By holding requests
+// back here we can keep a couple of slots free, so render-blocking resources never wait behind images.
+class RequestScheduler {
+public:
+    enum class Priority {
+        RenderBlocking,
+        High,
+        Normal,
+        Low,
+        __Count,
+    };
+
+    explicit RequestScheduler(u32 max_in_flight);
+
+    void schedule(Priority, Function<void()> start);
+    // NOTE: Also called for requests that are still running but have been going for long enough to give their slot back.
+    void did_finish(Priority);
+
+    u32 in_flight() const { return m_in_flight_total; }
+
+private:
+    bool can_start(Priority) const;
+    void start_pending();
+
+    static constexpr size_t priority_count = to_underlying(Priority::__Count);
+
+    u32 m_max_in_flight { 0 };
+    u32 m_in_flight_total { 0 };
+    Array<u32, priority_count> m_in_flight {};
+    Array<Queue<Function<void()>>, priority_count> m_pending;
+};
+
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RequestTiming.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
+#include <time.h>
+
+namespace Ladybird {
+
+i64 RequestTiming::total() const
+{
+    i64 total = 0;
+    for (auto phase : { blocked, dns, connect, send, wait, receive }) {
+        if (phase > 0)
+            total += phase;
+    }
+    return total;
+}
+
+static DeprecatedString iso8601_from_microseconds(i64 microseconds)
+{
+    time_t seconds = microseconds / 1'000'000;
+    struct tm tm {};
+    gmtime_r(&seconds, &tm);
+
+    return DeprecatedString::formatted("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.{:03}Z",
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, (microseconds / 1000) % 1000);
+}
+
+static double milliseconds_or_not_applicable(i64 microseconds)
+{
+    if (microseconds < 0)
+        return -1;
+    return static_cast<double>(microseconds) / 1000.0;
+}
+
+ErrorOr<DeprecatedString> serialize_as_har(ReadonlySpan<RequestTiming> timings)
+{
+    JsonArray entries;
+
+    for (auto const& timing : timings) {
+        JsonObject request;
+        request.set("method"sv, timing.method);
+        request.set("url"sv, timing.url);
+        request.set("httpVersion"sv, timing.http_version);
+        request.set("cookies"sv, JsonArray {});
+        request.set("headers"sv, JsonArray {});
+        request.set("queryString"sv, JsonArray {});
+        request.set("headersSize"sv, timing.request_header_size ? static_cast<i64>(timing.request_header_size) : -1);
+        request.set("bodySize"sv, static_cast<i64>(timing.request_body_size));
+
+        JsonObject content;
+        content.set("size"sv, timing.decoded_body_size);
+        content.set("mimeType"sv, timing.mime_type.is_null() ? DeprecatedString::empty() : timing.mime_type);
+
+        JsonObject response;
+        response.set("status"sv, timing.status_code);
+        response.set("statusText"sv, "");
+        response.set("httpVersion"sv, timing.http_version);
+        response.set("cookies"sv, JsonArray {});
+        response.set("headers"sv, JsonArray {});
+        response.set("content"sv, move(content));
+        response.set("redirectURL"sv, "");
+        response.set("headersSize"sv, timing.from_cache || !timing.response_header_size ? -1 : static_cast<i64>(timing.response_header_size));
+        response.set("bodySize"sv, timing.from_cache ? 0 : static_cast<i64>(timing.response_body_size));
+
+        JsonObject phases;
+        phases.set("blocked"sv, milliseconds_or_not_applicable(timing.blocked));
+        phases.set("dns"sv, milliseconds_or_not_applicable(timing.dns));
+        phases.set("connect"sv, milliseconds_or_not_applicable(timing.connect));
+        phases.set("ssl"sv, milliseconds_or_not_applicable(timing.tls));
+        phases.set("send"sv, max(0.0, milliseconds_or_not_applicable(timing.send)));
+        phases.set("wait"sv, max(0.0, milliseconds_or_not_applicable(timing.wait)));
+        phases.set("receive"sv, max(0.0, milliseconds_or_not_applicable(timing.receive)));
+
+        JsonObject entry;
+        entry.set("startedDateTime"sv, iso8601_from_microseconds(timing.start_time));
+        entry.set("time"sv, milliseconds_or_not_applicable(timing.total()));
+        entry.set("request"sv, move(request));
+        entry.set("response"sv, move(response));
+        entry.set("cache"sv, JsonObject {});
+        entry.set("timings"sv, move(phases));
+        TRY(entries.append(move(entry)));
+    }
+
+    JsonObject creator;
+    creator.set("name"sv, "LibWebGTK");
+    creator.set("version"sv, "0.0.1");
+
+    JsonObject log;
+    log.set("version"sv, "1.2");
+    log.set("creator"sv, move(creator));
+    log.set("pages"sv, JsonArray {});
+    log.set("entries"sv, move(entries));
+
+    JsonObject har;
+    har.set("log"sv, move(log));
+    return har.to_deprecated_string();
+}
+
+}
+
+template<>
+ErrorOr<void> IPC::encode(Encoder& encoder, Ladybird::RequestTiming const& timing)
+{
+    TRY(encoder.encode(timing.method));
+    TRY(encoder.encode(timing.url));
+    TRY(encoder.encode(timing.status_code));
+    TRY(encoder.encode(timing.http_version));
+    TRY(encoder.encode(timing.mime_type));
+    TRY(encoder.encode(timing.from_cache));
+    TRY(encoder.encode(timing.start_time));
+    TRY(encoder.encode(timing.blocked));
+    TRY(encoder.encode(timing.dns));
+    TRY(encoder.encode(timing.connect));
+    TRY(encoder.encode(timing.tls));
+    TRY(encoder.encode(timing.send));
+    TRY(encoder.encode(timing.wait));
+    TRY(encoder.encode(timing.receive));
+    TRY(encoder.encode(timing.request_header_size));
+    TRY(encoder.encode(timing.request_body_size));
+    TRY(encoder.encode(timing.response_header_size));
+    TRY(encoder.encode(timing.response_body_size));
+    TRY(encoder.encode(timing.decoded_body_size));
+    return {};
+}
+
+template<>
+ErrorOr<Ladybird::RequestTiming> IPC::decode(Decoder& decoder)
+{
+    Ladybird::RequestTiming timing;
+    timing.method = TRY(decoder.decode<DeprecatedString>());
+    timing.url = TRY(decoder.decode<DeprecatedString>());
+    timing.status_code = TRY(decoder.decode<u32>());
+    timing.http_version = TRY(decoder.decode<DeprecatedString>());
+    timing.mime_type = TRY(decoder.decode<DeprecatedString>());
+    timing.from_cache = TRY(decoder.decode<bool>());
+    timing.start_time = TRY(decoder.decode<i64>());
+    timing.blocked = TRY(decoder.decode<i64>());
+    timing.dns = TRY(decoder.decode<i64>());
+    timing.connect = TRY(decoder.decode<i64>());
+    timing.tls = TRY(decoder.decode<i64>());
+    timing.send = TRY(decoder.decode<i64>());
+    timing.wait = TRY(decoder.decode<i64>());
+    timing.receive = TRY(decoder.decode<i64>());
+    timing.request_header_size = TRY(decoder.decode<u64>());
+    timing.request_body_size = TRY(decoder.decode<u64>());
+    timing.response_header_size = TRY(decoder.decode<u64>());
+    timing.response_body_size = TRY(decoder.decode<u64>());
+    timing.decoded_body_size = TRY(decoder.decode<u64>());
+    return timing;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/Span.h>
+#include <LibIPC/Forward.h>
+
+namespace Ladybird {
+
+// Where the time went for a single request, laid out the way HAR describes it.
+struct RequestTiming {
+    DeprecatedString method;
+    DeprecatedString url;
+    u32 status_code { 0 };
+    DeprecatedString http_version;
+    DeprecatedString mime_type;
+    bool from_cache { false };
+
+    // Wall clock time the request was made, in microseconds since the epoch.
+    i64 start_time { 0 };
+
+    // Phase durations in microseconds, or -1 where a phase didn't happen (e.g. no DNS lookup on a reused connection).
+    i64 blocked { -1 };
+    i64 dns { -1 };
+    i64 connect { -1 };
+    i64 tls { -1 };
+    i64 send { -1 };
+    i64 wait { -1 };
+    i64 receive { -1 };
+
+    u64 request_header_size { 0 };
+    u64 request_body_size { 0 };
+    u64 response_header_size { 0 };
+    u64 response_body_size { 0 };
+    u64 decoded_body_size { 0 };
+
+    // NOTE: As in HAR, the TLS handshake is part of connect and isn't counted twice.
+    i64 total() const;
+};
+
+ErrorOr<DeprecatedString> serialize_as_har(ReadonlySpan<RequestTiming>);
+
+}
+
+namespace IPC {
+
+template<>
+ErrorOr<void> encode(Encoder&, Ladybird::RequestTiming const&);
+
+template<>
+ErrorOr<Ladybird::RequestTiming> decode(Decoder&);
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ResourceBundle.h"
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <gio/gio.h>
+
+namespace Ladybird {
+
+// NOTE: Only ever touched from the main thread.
+static DeprecatedString s_resource_root;
+static GResource* s_bundle { nullptr };
+// Lookups keep their GBytes, so the bytes handed out stay valid.
+static HashMap<DeprecatedString, GBytes*> s_resources;
+
+void ResourceBundle::load(StringView resource_root)
+{
+    s_resource_root = resource_root;
+
+    // NOTE: g_resource_load() maps the file, nothing is read until a resource is looked up.
+    auto path = DeprecatedString::formatted("{}/{}", resource_root, file_name);
+    GError* error = nullptr;
+    s_bundle = g_resource_load(path.characters(), &error);
+    if (!s_bundle) {
+        dbgln("No resource bundle, reading resources from {}: {}", resource_root, error->message);
+        g_error_free(error);
+    }
+}
+
+Optional<ReadonlyBytes> ResourceBundle::lookup(StringView path)
+{
+    if (!s_bundle)
+        return {};
+
+    DeprecatedString key = path;
+    auto it = s_resources.find(key);
+    if (it == s_resources.end()) {
+        // NOTE: Misses are remembered too, as a null GBytes.
+        auto resource_path = DeprecatedString::formatted("/{}", path);
+        s_resources.set(key, g_resource_lookup_data(s_bundle, resource_path.characters(), G_RESOURCE_LOOKUP_FLAGS_NONE, nullptr));
+        it = s_resources.find(key);
+    }
+    if (!it->value)
+        return {};
+
+    gsize size = 0;
+    auto const* data = static_cast<u8 const*>(g_bytes_get_data(it->value, &size));
+    return ReadonlyBytes { data, size };
+}
+
+ErrorOr<ByteBuffer> ResourceBundle::read(StringView path)
+{
+    if (auto bytes = lookup(path); bytes.has_value())
+        return ByteBuffer::copy(*bytes);
+
+    auto file = TRY(Core::File::open(DeprecatedString::formatted("{}/{}", s_resource_root, path), Core::File::OpenMode::Read));
+    return file->read_until_eof();
+}
+
+ErrorOr<NonnullOwnPtr<Core::File>> ResourceBundle::open(StringView path)
+{
+    auto bytes = lookup(path);
+    if (!bytes.has_value())
+        return Core::File::open(DeprecatedString::formatted("{}/{}", s_resource_root, path), Core::File::OpenMode::Read);
+
+    auto fd = TRY(Core::System::anon_create(max<size_t>(bytes->size(), 1), O_CLOEXEC));
+    auto file = TRY(Core::File::adopt_fd(fd, Core::File::OpenMode::ReadWrite));
+    TRY(Core::System::ftruncate(fd, bytes->size()));
+    for (size_t written = 0; written < bytes->size();)
+        written += TRY(file->write_some(bytes->slice(written)));
+    TRY(file->seek(0, SeekMode::SetPosition));
+
+    return file;
+}
+
+Optional<StringView> ResourceBundle::relative_path(StringView absolute_path)
+{
+    if (s_resource_root.is_empty() || !absolute_path.starts_with(s_resource_root) || absolute_path.length() <= s_resource_root.length() + 1)
+        return {};
+    if (absolute_path[s_resource_root.length()] != '/')
+        return {};
+    return absolute_path.substring_view(s_resource_root.length() + 1);
+}
+
+}
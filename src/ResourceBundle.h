@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <LibCore/File.h>
+
+namespace Ladybird {
+
+// The resources we read ourselves (themes, error pages, content filter lists), packed by the build into one GResource file
+// that's mapped once per process, rather than each of them being looked up and opened on its own.
+// Paths are relative to the resource root, e.g. "res/themes/Default.ini".
+// NOTE: Whatever isn't in the bundle, or everything if there's no bundle, is read from the resource root like before.
+//       Fonts and emoji aren't bundled, LibGfx only knows how to find those in a directory.
+class ResourceBundle {
+public:
+    static constexpr StringView file_name = "res/webembed.gresource"sv;
+
+    static void load(StringView resource_root);
+
+    // Points into the mapped bundle, which stays around for the rest of the process.
+    static Optional<ReadonlyBytes> lookup(StringView path);
+
+    static ErrorOr<ByteBuffer> read(StringView path);
+
+    // For APIs that can only read from a file. Bundled resources are handed out as an in-memory file.
+    static ErrorOr<NonnullOwnPtr<Core::File>> open(StringView path);
+
+    // The path of a resource under the resource root, if an absolute path points at one.
+    static Optional<StringView> relative_path(StringView absolute_path);
+};
+
+}
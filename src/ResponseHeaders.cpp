@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ResponseHeaders.h"
+#include <AK/JsonArraySerializer.h>
+#include <AK/StringBuilder.h>
+
+namespace Ladybird {
+
+// NOTE: LibWeb only takes headers as a map of DeprecatedStrings, so every name and value still gets its own allocation here.
+//       What this saves over building the map header by header is the rehashing, and a JsonArray holding every Set-Cookie value.
+HttpCache::HeaderMap header_map_from_soup(SoupMessageHeaders* soup_headers)
+{
+    SoupMessageHeadersIter iter;
+    char const *c_name, *c_value;
+
+    size_t header_count = 0;
+    soup_message_headers_iter_init(&iter, soup_headers);
+    while (soup_message_headers_iter_next(&iter, &c_name, &c_value))
+        ++header_count;
+
+    HttpCache::HeaderMap headers;
+    headers.ensure_capacity(header_count);
+
+    // NOTE: LibWeb expects every Set-Cookie value in a single JSON array, so serialize them straight into one buffer.
+    StringBuilder set_cookie_builder;
+    Optional<JsonArraySerializer<StringBuilder>> set_cookie_serializer;
+
+    soup_message_headers_iter_init(&iter, soup_headers);
+    while (soup_message_headers_iter_next(&iter, &c_name, &c_value)) {
+        if (g_ascii_strcasecmp(c_name, "Set-Cookie") == 0) {
+            if (!set_cookie_serializer.has_value())
+                set_cookie_serializer = MUST(JsonArraySerializer<>::try_create(set_cookie_builder));
+            MUST(set_cookie_serializer->add(StringView { c_value, strlen(c_value) }));
+            continue;
+        }
+
+        // RFC 9110 5.3: Repeated fields are combined into a comma-separated list.
+        DeprecatedString name { c_name };
+        if (auto it = headers.find(name); it != headers.end())
+            it->value = DeprecatedString::formatted("{}, {}", it->value, c_value);
+        else
+            headers.set(move(name), DeprecatedString { c_value });
+    }
+
+    if (set_cookie_serializer.has_value()) {
+        MUST(set_cookie_serializer->finish());
+        headers.set("Set-Cookie"sv, set_cookie_builder.to_deprecated_string());
+    }
+
+    return headers;
+}
+
+}
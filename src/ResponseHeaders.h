@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "HttpCache.h"
+#include <libsoup/soup.h>
+
+namespace Ladybird {
+
+// Response headers the way LibWeb wants them: one entry per field, with every Set-Cookie value in a JSON array.
+HttpCache::HeaderMap header_map_from_soup(SoupMessageHeaders*);
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include "Utilities.h"
+#include "ResourceBundle.h"
 #include <AK/LexicalPath.h>
 #include <AK/Platform.h>
 #include <LibFileSystem/FileSystem.h>
@@ -72,4 +73,6 @@ void platform_init()
 #    endif
     }();
 #endif
+
+    Ladybird::ResourceBundle::load(s_serenity_resource_root);
 }
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "EmbedConnectionFromClient.h"
+
+namespace Ladybird {
+
+EmbedConnectionFromClient::EmbedConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> socket, NonnullRefPtr<RequestManager> request_manager)
+    : IPC::ConnectionFromClient<EmbedClientEndpoint, EmbedServerEndpoint>(*this, move(socket), 1)
+    , m_request_manager(move(request_manager))
+{
+    m_request_manager->on_upload_progress = [this](AK::URL const& url, u64 bytes_sent, u64 total_bytes) {
+        async_did_upload_progress(url, bytes_sent, total_bytes);
+    };
+
+    m_request_manager->on_custom_scheme_request = [this](AK::URL const& url) -> NonnullRefPtr<Web::ResourceLoaderConnectorRequest> {
+        auto request_id = m_next_uri_scheme_request_id++;
+        auto request = adopt_ref(*new UriSchemeRequest);
+        m_uri_scheme_requests.set(request_id, request);
+        async_did_request_uri_scheme(request_id, url);
+        return request;
+    };
+}
+
+void EmbedConnectionFromClient::die()
+{
+    // NOTE: The main WebContent connection decides when this process exits, so there's nothing to do here.
+    //       Requests the embedder was going to answer won't be, though.
+    auto requests = move(m_uri_scheme_requests);
+    for (auto& it : requests)
+        it.value->on_buffered_request_finish(false, 0, {}, {}, {});
+}
+
+Messages::EmbedServer::GetHttpCacheStatisticsResponse EmbedConnectionFromClient::get_http_cache_statistics()
+{
+    auto statistics = m_request_manager->http_cache_statistics();
+    if (!statistics.has_value())
+        return { false, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    return { true, statistics->memory_hits, statistics->disk_hits, statistics->revalidations, statistics->misses, statistics->stores, statistics->evictions, statistics->memory_size, statistics->disk_size };
+}
+
+Messages::EmbedServer::GetRequestTimingsResponse EmbedConnectionFromClient::get_request_timings()
+{
+    return { m_request_manager->timings() };
+}
+
+void EmbedConnectionFromClient::clear_request_timings()
+{
+    m_request_manager->clear_timings();
+}
+
+Messages::EmbedServer::GetCoalescedRequestCountResponse EmbedConnectionFromClient::get_coalesced_request_count()
+{
+    return { m_request_manager->coalesced_request_count() };
+}
+
+Messages::EmbedServer::GetPreloadStatisticsResponse EmbedConnectionFromClient::get_preload_statistics()
+{
+    auto statistics = m_request_manager->preload_statistics();
+    return { statistics.issued, statistics.used, statistics.wasted };
+}
+
+Messages::EmbedServer::GetTlsStatisticsResponse EmbedConnectionFromClient::get_tls_statistics()
+{
+    auto statistics = m_request_manager->tls_statistics();
+    return { statistics.handshakes, statistics.resumption_attempts, statistics.resumed, statistics.handshake_time };
+}
+
+void EmbedConnectionFromClient::set_network_conditions(u32 latency_ms, u64 download_throughput, u64 upload_throughput, double failure_rate)
+{
+    m_request_manager->set_network_conditions({
+        .latency_ms = latency_ms,
+        .download_throughput = download_throughput,
+        .upload_throughput = upload_throughput,
+        .failure_rate = failure_rate,
+    });
+}
+
+void EmbedConnectionFromClient::preconnect(URL const& url)
+{
+    m_request_manager->preconnect(url);
+}
+
+void EmbedConnectionFromClient::prefetch(URL const& url, HashMap<DeprecatedString, DeprecatedString> const& request_headers)
+{
+    m_request_manager->prefetch(url, request_headers);
+}
+
+void EmbedConnectionFromClient::register_uri_scheme(DeprecatedString const& scheme)
+{
+    m_request_manager->register_custom_scheme(scheme);
+}
+
+void EmbedConnectionFromClient::finish_uri_scheme_request(i32 request_id, bool success, DeprecatedString const& content_type, Core::AnonymousBuffer const& body)
+{
+    auto request = m_uri_scheme_requests.take(request_id);
+    if (!request.has_value())
+        return;
+
+    // NOTE: The body stays in the shared memory the embedder wrote it to, LibWeb copies what it keeps.
+    ReadonlyBytes payload;
+    if (body.is_valid())
+        payload = body.bytes();
+
+    HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> response_headers;
+    if (success) {
+        if (!content_type.is_empty())
+            response_headers.set("Content-Type", content_type);
+        response_headers.set("Content-Length", DeprecatedString::number(payload.size()));
+    }
+
+    (*request)->on_buffered_request_finish(success, payload.size(), response_headers, {}, payload);
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "../RequestManager.h"
+#include <LibIPC/ConnectionFromClient.h>
+#include <WebContent/EmbedClientEndpoint.h>
+#include <WebContent/EmbedServerEndpoint.h>
+
+namespace Ladybird {
+
+// Our own connection to the embedding application, next to the one LibWebView establishes.
+// It carries everything that isn't part of the upstream WebContent protocol.
+class EmbedConnectionFromClient final
+    : public IPC::ConnectionFromClient<EmbedClientEndpoint, EmbedServerEndpoint> {
+    C_OBJECT(EmbedConnectionFromClient);
+
+public:
+    virtual ~EmbedConnectionFromClient() override = default;
+
+    virtual void die() override;
+
+private:
+    EmbedConnectionFromClient(NonnullOwnPtr<Core::LocalSocket>, NonnullRefPtr<RequestManager>);
+
+    virtual Messages::EmbedServer::GetHttpCacheStatisticsResponse get_http_cache_statistics() override;
+    virtual Messages::EmbedServer::GetRequestTimingsResponse get_request_timings() override;
+    virtual void clear_request_timings() override;
+    virtual Messages::EmbedServer::GetCoalescedRequestCountResponse get_coalesced_request_count() override;
+    virtual Messages::EmbedServer::GetPreloadStatisticsResponse get_preload_statistics() override;
+    virtual Messages::EmbedServer::GetTlsStatisticsResponse get_tls_statistics() override;
+    virtual void set_network_conditions(u32 latency_ms, u64 download_throughput, u64 upload_throughput, double failure_rate) override;
+    virtual void preconnect(URL const&) override;
+    virtual void prefetch(URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers) override;
+    virtual void register_uri_scheme(DeprecatedString const& scheme) override;
+    virtual void finish_uri_scheme_request(i32 request_id, bool success, DeprecatedString const& content_type, Core::AnonymousBuffer const& body) override;
+
+    class UriSchemeRequest
+        : public Web::ResourceLoaderConnectorRequest {
+    public:
+        virtual ~UriSchemeRequest() override = default;
+
+        virtual void set_should_buffer_all_input(bool) override { }
+        virtual bool stop() override { return false; }
+        virtual void stream_into(Stream&) override { }
+    };
+
+    NonnullRefPtr<RequestManager> m_request_manager;
+    HashMap<i32, NonnullRefPtr<UriSchemeRequest>> m_uri_scheme_requests;
+    i32 m_next_uri_scheme_request_id { 0 };
+};
+
+}
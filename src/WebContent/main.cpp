@@ -7,10 +7,16 @@
 #include "../AudioCodecPluginLadybird.h"
 #include "../EventLoopImplementationGLib.h"
 #include "../FontPluginPango.h"
+#include "../HelperProcess.h"
 #include "../ImageCodecPluginLadybird.h"
+#include "../NetworkServerClient.h"
+#include "../NetworkSettings.h"
+#include "../RequestManagerNetworkServer.h"
 #include "../RequestManagerSoup.h"
+#include "../ResourceBundle.h"
 #include "../Utilities.h"
-// #include "../WebSocketClientManagerLadybird.h"
+#include "EmbedConnectionFromClient.h"
+#include "../WebSocketClientManagerLadybird.h"
 #include <AK/LexicalPath.h>
 #include <AK/Platform.h>
 #include <LibAudio/Loader.h>
@@ -32,16 +38,17 @@
 #include <WebContent/ConnectionFromClient.h>
 #include <WebContent/PageHost.h>
 #include <WebContent/WebDriverConnection.h>
+#include <fcntl.h>
 #include <gtkmm/application.h>
 
 #if defined(AK_OS_MACOS)
 #    include "MacOSSetup.h"
-#include "../RequestManagerSoup.h"
-
 #endif
 
 static ErrorOr<void> load_content_filters();
 static ErrorOr<void> load_autoplay_allowlist();
+static NonnullRefPtr<Ladybird::RequestManager> create_request_manager();
+static ErrorOr<NonnullRefPtr<Ladybird::EmbedConnectionFromClient>> connect_to_embedder(StringView socket_fd, NonnullRefPtr<Ladybird::RequestManager>);
 
 extern DeprecatedString s_serenity_resource_root;
 
@@ -67,8 +74,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     });
 
     // TODO: WE DEFINITELY NEED THESE !!
-    Web::ResourceLoader::initialize(RequestManagerSoup::create());
-    //Web::WebSockets::WebSocketClientManager::initialize(Ladybird::WebSocketClientManagerLadybird::create());
+    auto request_manager = create_request_manager();
+    Web::ResourceLoader::initialize(request_manager);
+    Web::WebSockets::WebSocketClientManager::initialize(Ladybird::WebSocketClientManagerLadybird::create());
 
     Web::FrameLoader::set_default_favicon_path(DeprecatedString::formatted("{}/res/icons/16x16/app-browser.png", s_serenity_resource_root));
 
@@ -104,25 +112,60 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto webcontent_client = TRY(WebContent::ConnectionFromClient::try_create(move(webcontent_socket)));
     webcontent_client->set_fd_passing_socket(TRY(Core::LocalSocket::adopt_fd(webcontent_fd_passing_socket)));
 
+    RefPtr<Ladybird::EmbedConnectionFromClient> embed_client;
+    if (auto const* embed_socket_fd = getenv(EMBED_SOCKET_FD_ENV)) {
+        auto embed_client_or_error = connect_to_embedder({ embed_socket_fd, strlen(embed_socket_fd) }, request_manager);
+        if (embed_client_or_error.is_error())
+            dbgln("Failed to connect to embedder: {}", embed_client_or_error.error());
+        else
+            embed_client = embed_client_or_error.release_value();
+    }
+
     return event_loop.exec();
 }
 
-static ErrorOr<void> load_content_filters()
+static NonnullRefPtr<Ladybird::RequestManager> create_request_manager()
+{
+    if (auto const* socket_path = getenv(NETWORK_SERVER_SOCKET_ENV)) {
+        auto client_or_error = Ladybird::NetworkServerClient::connect({ socket_path, strlen(socket_path) });
+        if (!client_or_error.is_error())
+            return Ladybird::RequestManagerNetworkServer::create(client_or_error.release_value());
+        dbgln("Failed to connect to NetworkServer, loading in-process instead: {}", client_or_error.error());
+    }
+
+    return RequestManagerSoup::create(Ladybird::NetworkSettings::from_environment());
+}
+
+static ErrorOr<NonnullRefPtr<Ladybird::EmbedConnectionFromClient>> connect_to_embedder(StringView socket_fd, NonnullRefPtr<Ladybird::RequestManager> request_manager)
 {
-    auto file_or_error = Core::File::open(DeprecatedString::formatted("{}/home/anon/.config/BrowserContentFilters.txt", s_serenity_resource_root), Core::File::OpenMode::Read);
-    if (file_or_error.is_error())
-        file_or_error = Core::File::open(DeprecatedString::formatted("{}/res/ladybird/BrowserContentFilters.txt", s_serenity_resource_root), Core::File::OpenMode::Read);
-    if (file_or_error.is_error())
-        return file_or_error.release_error();
+    auto fd = socket_fd.to_int();
+    if (!fd.has_value())
+        return Error::from_string_literal("Invalid embed socket file descriptor");
 
-    auto file = file_or_error.release_value();
-    auto ad_filter_list = TRY(Core::InputBufferedFile::create(move(file)));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(4096));
+    // Don't leak the socket into any processes we might spawn ourselves.
+    TRY(Core::System::fcntl(*fd, F_SETFD, FD_CLOEXEC));
+
+    auto socket = TRY(Core::LocalSocket::adopt_fd(*fd));
+    return Ladybird::EmbedConnectionFromClient::try_create(move(socket), move(request_manager));
+}
+
+// NOTE: A list of the user's own takes precedence over the one we ship.
+static ErrorOr<ByteBuffer> read_list(StringView name)
+{
+    auto user_file = Core::File::open(DeprecatedString::formatted("{}/home/anon/.config/{}", s_serenity_resource_root, name), Core::File::OpenMode::Read);
+    if (!user_file.is_error())
+        return user_file.value()->read_until_eof();
+
+    return Ladybird::ResourceBundle::read(DeprecatedString::formatted("res/ladybird/{}", name));
+}
+
+static ErrorOr<void> load_content_filters()
+{
+    auto contents = TRY(read_list("BrowserContentFilters.txt"sv));
 
     Vector<String> patterns;
 
-    while (TRY(ad_filter_list->can_read_line())) {
-        auto line = TRY(ad_filter_list->read_line(buffer));
+    for (auto line : StringView { contents }.lines()) {
         if (line.is_empty())
             continue;
 
@@ -138,20 +181,11 @@ static ErrorOr<void> load_content_filters()
 
 static ErrorOr<void> load_autoplay_allowlist()
 {
-    auto file_or_error = Core::File::open(TRY(String::formatted("{}/home/anon/.config/BrowserAutoplayAllowlist.txt", s_serenity_resource_root)), Core::File::OpenMode::Read);
-    if (file_or_error.is_error())
-        file_or_error = Core::File::open(TRY(String::formatted("{}/res/ladybird/BrowserAutoplayAllowlist.txt", s_serenity_resource_root)), Core::File::OpenMode::Read);
-    if (file_or_error.is_error())
-        return file_or_error.release_error();
-
-    auto file = file_or_error.release_value();
-    auto allowlist = TRY(Core::InputBufferedFile::create(move(file)));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(4096));
+    auto contents = TRY(read_list("BrowserAutoplayAllowlist.txt"sv));
 
     Vector<String> origins;
 
-    while (TRY(allowlist->can_read_line())) {
-        auto line = TRY(allowlist->read_line(buffer));
+    for (auto line : StringView { contents }.lines()) {
         if (line.is_empty())
             continue;
 
@@ -6,7 +6,6 @@
  */
 
 #include "WebSocketClientManagerLadybird.h"
-#include "WebSocketImplQt.h"
 #include "WebSocketLadybird.h"
 
 namespace Ladybird {
@@ -16,19 +15,22 @@ NonnullRefPtr<WebSocketClientManagerLadybird> WebSocketClientManagerLadybird::cr
     return adopt_ref(*new WebSocketClientManagerLadybird());
 }
 
-WebSocketClientManagerLadybird::WebSocketClientManagerLadybird() = default;
-WebSocketClientManagerLadybird::~WebSocketClientManagerLadybird() = default;
+WebSocketClientManagerLadybird::WebSocketClientManagerLadybird()
+    : m_session(soup_session_new())
+{
+    // NOTE: The extension manager negotiates permessage-deflate. libsoup3 adds it by default, but make sure it's there.
+    if (!soup_session_has_feature(m_session, SOUP_TYPE_WEBSOCKET_EXTENSION_MANAGER))
+        soup_session_add_feature_by_type(m_session, SOUP_TYPE_WEBSOCKET_EXTENSION_MANAGER);
+}
 
-RefPtr<Web::WebSockets::WebSocketClientSocket> WebSocketClientManagerLadybird::connect(AK::URL const& url, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols)
+WebSocketClientManagerLadybird::~WebSocketClientManagerLadybird()
 {
-    WebSocket::ConnectionInfo connection_info(url);
-    connection_info.set_origin(origin);
-    connection_info.set_protocols(protocols);
+    g_object_unref(m_session);
+}
 
-    auto impl = adopt_ref(*new WebSocketImplQt);
-    auto web_socket = WebSocket::WebSocket::create(move(connection_info), move(impl));
-    web_socket->start();
-    return WebSocketLadybird::create(web_socket);
+RefPtr<Web::WebSockets::WebSocketClientSocket> WebSocketClientManagerLadybird::connect(AK::URL const& url, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols)
+{
+    return WebSocketLadybird::create(m_session, url, origin, protocols);
 }
 
 }
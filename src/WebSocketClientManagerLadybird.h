@@ -5,13 +5,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <LibWeb/WebSockets/WebSocket.h>
-#include <LibWebSocket/ConnectionInfo.h>
-#include <LibWebSocket/Message.h>
-#include <LibWebSocket/WebSocket.h>
-
 #pragma once
 
+#include <LibWeb/WebSockets/WebSocket.h>
+#include <libsoup/soup.h>
+
 namespace Ladybird {
 
 class WebSocketClientManagerLadybird : public Web::WebSockets::WebSocketClientManager {
@@ -23,6 +21,9 @@ public:
 
 private:
     WebSocketClientManagerLadybird();
+
+    // NOTE: WebSockets get a session of their own on the main thread, as their messages are delivered straight to LibWeb.
+    SoupSession* m_session { nullptr };
 };
 
 }
@@ -6,69 +6,173 @@
  */
 
 #include "WebSocketLadybird.h"
+#include <LibCore/EventLoop.h>
 
 namespace Ladybird {
 
-NonnullRefPtr<WebSocketLadybird> WebSocketLadybird::create(NonnullRefPtr<WebSocket::WebSocket> underlying_socket)
+// libsoup's default of 128KiB is far below what pages expect to be able to receive in one message.
+static constexpr guint64 MAX_INCOMING_PAYLOAD_SIZE = 64 * MiB;
+// Used when the connection went away without a close frame.
+static constexpr u16 CLOSE_CODE_ABNORMAL = 1006;
+
+NonnullRefPtr<WebSocketLadybird> WebSocketLadybird::create(SoupSession* session, AK::URL const& url, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols)
 {
-    return adopt_ref(*new WebSocketLadybird(move(underlying_socket)));
+    auto web_socket = adopt_ref(*new WebSocketLadybird());
+    web_socket->connect(session, url, origin, protocols);
+    return web_socket;
 }
 
-WebSocketLadybird::WebSocketLadybird(NonnullRefPtr<WebSocket::WebSocket> underlying_socket)
-    : m_websocket(move(underlying_socket))
+WebSocketLadybird::WebSocketLadybird()
+    : m_cancellable(g_cancellable_new())
 {
-    m_websocket->on_open = [weak_this = make_weak_ptr()] {
-        if (auto strong_this = weak_this.strong_ref())
-            if (strong_this->on_open)
-                strong_this->on_open();
-    };
-    m_websocket->on_message = [weak_this = make_weak_ptr()](auto message) {
-        if (auto strong_this = weak_this.strong_ref()) {
-            if (strong_this->on_message) {
-                strong_this->on_message(Web::WebSockets::WebSocketClientSocket::Message {
-                    .data = move(message.data()),
-                    .is_text = message.is_text(),
-                });
-            }
-        }
-    };
-    m_websocket->on_error = [weak_this = make_weak_ptr()](auto error) {
-        if (auto strong_this = weak_this.strong_ref()) {
-            if (strong_this->on_error) {
-                switch (error) {
-                case WebSocket::WebSocket::Error::CouldNotEstablishConnection:
-                    strong_this->on_error(Web::WebSockets::WebSocketClientSocket::Error::CouldNotEstablishConnection);
-                    return;
-                case WebSocket::WebSocket::Error::ConnectionUpgradeFailed:
-                    strong_this->on_error(Web::WebSockets::WebSocketClientSocket::Error::ConnectionUpgradeFailed);
-                    return;
-                case WebSocket::WebSocket::Error::ServerClosedSocket:
-                    strong_this->on_error(Web::WebSockets::WebSocketClientSocket::Error::ServerClosedSocket);
-                    return;
-                }
-                VERIFY_NOT_REACHED();
-            }
-        }
-    };
-    m_websocket->on_close = [weak_this = make_weak_ptr()](u16 code, DeprecatedString reason, bool was_clean) {
-        if (auto strong_this = weak_this.strong_ref())
-            if (strong_this->on_close)
-                strong_this->on_close(code, move(reason), was_clean);
-    };
 }
 
-WebSocketLadybird::~WebSocketLadybird() = default;
+WebSocketLadybird::~WebSocketLadybird()
+{
+    g_cancellable_cancel(m_cancellable);
+    g_object_unref(m_cancellable);
+
+    if (m_connection) {
+        g_signal_handlers_disconnect_by_data(m_connection, this);
+        if (soup_websocket_connection_get_state(m_connection) == SOUP_WEBSOCKET_STATE_OPEN)
+            soup_websocket_connection_close(m_connection, SOUP_WEBSOCKET_CLOSE_GOING_AWAY, nullptr);
+        g_object_unref(m_connection);
+    }
+}
+
+void WebSocketLadybird::connect(SoupSession* session, AK::URL const& url, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols)
+{
+    // NOTE: libsoup opens the connection as a regular HTTP(S) request and upgrades it from there.
+    auto serialized_url = url.serialize();
+    auto http_url = DeprecatedString::formatted("{}{}",
+        url.scheme().equals_ignoring_ascii_case("wss"sv) ? "https"sv : "http"sv,
+        serialized_url.substring_view(url.scheme().length()));
+
+    auto* message = soup_message_new(SOUP_METHOD_GET, http_url.characters());
+    if (!message) {
+        // NOTE: Nobody has had a chance to set up the callbacks yet.
+        Core::deferred_invoke([weak_this = make_weak_ptr()] {
+            if (auto strong_this = weak_this.strong_ref())
+                strong_this->fail(Error::CouldNotEstablishConnection);
+        });
+        return;
+    }
+
+    Vector<char const*> protocol_names;
+    for (auto const& protocol : protocols)
+        protocol_names.append(protocol.characters());
+    protocol_names.append(nullptr);
+
+    soup_session_websocket_connect_async(session,
+        message,
+        origin.is_empty() ? nullptr : origin.characters(),
+        protocols.is_empty() ? nullptr : const_cast<char**>(protocol_names.data()),
+        G_PRIORITY_DEFAULT,
+        m_cancellable,
+        did_connect,
+        new WeakPtr<WebSocketLadybird>(make_weak_ptr()));
+    g_object_unref(message);
+}
+
+void WebSocketLadybird::did_connect(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    auto weak_this = adopt_own(*static_cast<WeakPtr<WebSocketLadybird>*>(user_data));
+
+    GError* error = nullptr;
+    auto* connection = soup_session_websocket_connect_finish(SOUP_SESSION(source), result, &error);
+
+    // NOTE: A connection that was closed while it was being established has been reported as failed already.
+    auto strong_this = weak_this->strong_ref();
+    if (!strong_this || strong_this->m_has_failed) {
+        if (connection)
+            g_object_unref(connection);
+        if (error)
+            g_error_free(error);
+        return;
+    }
+
+    if (!connection) {
+        dbgln("WebSocket connection failed: {}", error->message);
+        auto reason = error->domain == SOUP_WEBSOCKET_ERROR ? Error::ConnectionUpgradeFailed : Error::CouldNotEstablishConnection;
+        g_error_free(error);
+        strong_this->fail(reason);
+        return;
+    }
+
+    strong_this->m_connection = connection;
+    soup_websocket_connection_set_max_incoming_payload_size(connection, MAX_INCOMING_PAYLOAD_SIZE);
+    g_signal_connect(connection, "message", G_CALLBACK(did_receive_message), strong_this.ptr());
+    g_signal_connect(connection, "error", G_CALLBACK(did_receive_error), strong_this.ptr());
+    g_signal_connect(connection, "closed", G_CALLBACK(did_close), strong_this.ptr());
+
+    if (strong_this->on_open)
+        strong_this->on_open();
+}
+
+void WebSocketLadybird::did_receive_message(SoupWebsocketConnection*, gint type, GBytes* message, gpointer user_data)
+{
+    auto* self = static_cast<WebSocketLadybird*>(user_data);
+    if (!self->on_message)
+        return;
+
+    // NOTE: This is the only copy a message sees, libsoup has already reassembled (and inflated) the frames into one buffer.
+    //       From here on the ByteBuffer is only ever moved.
+    gsize size = 0;
+    auto const* data = static_cast<u8 const*>(g_bytes_get_data(message, &size));
+    auto buffer_or_error = ByteBuffer::copy(data, size);
+    if (buffer_or_error.is_error()) {
+        soup_websocket_connection_close(self->m_connection, SOUP_WEBSOCKET_CLOSE_TOO_BIG, nullptr);
+        return;
+    }
+
+    self->on_message(Web::WebSockets::WebSocketClientSocket::Message {
+        .data = buffer_or_error.release_value(),
+        .is_text = type == SOUP_WEBSOCKET_DATA_TEXT,
+    });
+}
+
+void WebSocketLadybird::did_receive_error(SoupWebsocketConnection*, GError* error, gpointer user_data)
+{
+    auto* self = static_cast<WebSocketLadybird*>(user_data);
+    dbgln("WebSocket error: {}", error->message);
+
+    // NOTE: libsoup follows this up by closing the connection, which reports the close.
+    if (self->on_error)
+        self->on_error(Error::ServerClosedSocket);
+}
+
+void WebSocketLadybird::did_close(SoupWebsocketConnection* connection, gpointer user_data)
+{
+    auto* self = static_cast<WebSocketLadybird*>(user_data);
+    if (!self->on_close)
+        return;
+
+    auto code = soup_websocket_connection_get_close_code(connection);
+    auto const* reason = soup_websocket_connection_get_close_data(connection);
+    auto was_clean = code != 0 && code != CLOSE_CODE_ABNORMAL;
+    self->on_close(was_clean ? code : CLOSE_CODE_ABNORMAL, reason ? reason : "", was_clean);
+}
+
+void WebSocketLadybird::fail(Error error)
+{
+    m_has_failed = true;
+    if (on_error)
+        on_error(error);
+    if (on_close)
+        on_close(CLOSE_CODE_ABNORMAL, {}, false);
+}
 
 Web::WebSockets::WebSocket::ReadyState WebSocketLadybird::ready_state()
 {
-    switch (m_websocket->ready_state()) {
-    case WebSocket::ReadyState::Connecting:
-        return Web::WebSockets::WebSocket::ReadyState::Connecting;
-    case WebSocket::ReadyState::Open:
+    if (!m_connection)
+        return m_has_failed ? Web::WebSockets::WebSocket::ReadyState::Closed : Web::WebSockets::WebSocket::ReadyState::Connecting;
+
+    switch (soup_websocket_connection_get_state(m_connection)) {
+    case SOUP_WEBSOCKET_STATE_OPEN:
         return Web::WebSockets::WebSocket::ReadyState::Open;
-    case WebSocket::ReadyState::Closing:
+    case SOUP_WEBSOCKET_STATE_CLOSING:
         return Web::WebSockets::WebSocket::ReadyState::Closing;
-    case WebSocket::ReadyState::Closed:
+    case SOUP_WEBSOCKET_STATE_CLOSED:
         return Web::WebSockets::WebSocket::ReadyState::Closed;
     }
     VERIFY_NOT_REACHED();
@@ -76,22 +180,47 @@ Web::WebSockets::WebSocket::ReadyState WebSocketLadybird::ready_state()
 
 DeprecatedString WebSocketLadybird::subprotocol_in_use()
 {
-    return m_websocket->subprotocol_in_use();
+    if (!m_connection)
+        return {};
+    auto const* protocol = soup_websocket_connection_get_protocol(m_connection);
+    return protocol ? DeprecatedString { protocol } : DeprecatedString {};
 }
 
 void WebSocketLadybird::send(ByteBuffer binary_or_text_message, bool is_text)
 {
-    m_websocket->send(WebSocket::Message(binary_or_text_message, is_text));
+    if (!m_connection || soup_websocket_connection_get_state(m_connection) != SOUP_WEBSOCKET_STATE_OPEN)
+        return;
+
+    // NOTE: libsoup frames (and compresses) the payload before this returns, so it can borrow our buffer.
+    g_autoptr(GBytes) bytes = g_bytes_new_static(binary_or_text_message.data(), binary_or_text_message.size());
+    soup_websocket_connection_send_message(m_connection, is_text ? SOUP_WEBSOCKET_DATA_TEXT : SOUP_WEBSOCKET_DATA_BINARY, bytes);
 }
 
 void WebSocketLadybird::send(StringView message)
 {
-    m_websocket->send(WebSocket::Message(message));
+    if (!m_connection || soup_websocket_connection_get_state(m_connection) != SOUP_WEBSOCKET_STATE_OPEN)
+        return;
+
+    g_autoptr(GBytes) bytes = g_bytes_new_static(message.characters_without_null_termination(), message.length());
+    soup_websocket_connection_send_message(m_connection, SOUP_WEBSOCKET_DATA_TEXT, bytes);
 }
 
 void WebSocketLadybird::close(u16 code, DeprecatedString reason)
 {
-    m_websocket->close(code, reason);
+    if (!m_connection) {
+        // Closing a connection that's still being established fails it.
+        if (!m_has_failed) {
+            g_cancellable_cancel(m_cancellable);
+            fail(Error::CouldNotEstablishConnection);
+        }
+        return;
+    }
+
+    if (soup_websocket_connection_get_state(m_connection) != SOUP_WEBSOCKET_STATE_OPEN)
+        return;
+
+    // NOTE: 1005 means no code was given, which must not go out in a close frame.
+    soup_websocket_connection_close(m_connection, code == 1005 ? 0 : code, reason.is_empty() ? nullptr : reason.characters());
 }
 
 }
@@ -7,8 +7,9 @@
 
 #pragma once
 
+#include <AK/WeakPtr.h>
 #include <LibWeb/WebSockets/WebSocket.h>
-#include <LibWebSocket/WebSocket.h>
+#include <libsoup/soup.h>
 
 namespace Ladybird {
 
@@ -16,7 +17,7 @@ class WebSocketLadybird
     : public Web::WebSockets::WebSocketClientSocket
     , public Weakable<WebSocketLadybird> {
 public:
-    static NonnullRefPtr<WebSocketLadybird> create(NonnullRefPtr<WebSocket::WebSocket>);
+    static NonnullRefPtr<WebSocketLadybird> create(SoupSession*, AK::URL const&, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols);
 
     virtual ~WebSocketLadybird() override;
 
@@ -27,9 +28,19 @@ public:
     virtual void close(u16 code, DeprecatedString reason) override;
 
 private:
-    explicit WebSocketLadybird(NonnullRefPtr<WebSocket::WebSocket>);
+    WebSocketLadybird();
 
-    NonnullRefPtr<WebSocket::WebSocket> m_websocket;
+    void connect(SoupSession*, AK::URL const&, DeprecatedString const& origin, Vector<DeprecatedString> const& protocols);
+    void fail(Error);
+
+    static void did_connect(GObject* source, GAsyncResult* result, gpointer user_data);
+    static void did_receive_message(SoupWebsocketConnection* connection, gint type, GBytes* message, gpointer user_data);
+    static void did_receive_error(SoupWebsocketConnection* connection, GError* error, gpointer user_data);
+    static void did_close(SoupWebsocketConnection* connection, gpointer user_data);
+
+    SoupWebsocketConnection* m_connection { nullptr };
+    GCancellable* m_cancellable { nullptr };
+    bool m_has_failed { false };
 };
 
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ZstdDecompressor.h"
+#include <zstd.h>
+
+struct _WebZstdDecompressor
+{
+    GObject parent_instance;
+
+    ZSTD_DStream *stream;
+};
+
+static void
+web_zstd_decompressor_converter_init (GConverterIface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE (WebZstdDecompressor, web_zstd_decompressor, G_TYPE_OBJECT,
+                               G_IMPLEMENT_INTERFACE (G_TYPE_CONVERTER, web_zstd_decompressor_converter_init))
+
+GConverter *
+web_zstd_decompressor_new ()
+{
+    return G_CONVERTER (g_object_new (WEB_TYPE_ZSTD_DECOMPRESSOR, nullptr));
+}
+
+static GConverterResult
+web_zstd_decompressor_convert (GConverter *converter,
+                               const void *inbuf,
+                               gsize inbuf_size,
+                               void *outbuf,
+                               gsize outbuf_size,
+                               GConverterFlags flags,
+                               gsize *bytes_read,
+                               gsize *bytes_written,
+                               GError **error)
+{
+    auto *self = WEB_ZSTD_DECOMPRESSOR (converter);
+
+    ZSTD_inBuffer input { inbuf, inbuf_size, 0 };
+    ZSTD_outBuffer output { outbuf, outbuf_size, 0 };
+
+    auto result = ZSTD_decompressStream (self->stream, &output, &input);
+    if (ZSTD_isError (result)) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid zstd data: %s", ZSTD_getErrorName (result));
+        return G_CONVERTER_ERROR;
+    }
+
+    *bytes_read = input.pos;
+    *bytes_written = output.pos;
+
+    // NOTE: A return value of 0 means the current frame is complete and fully flushed.
+    //       A body may consist of several concatenated frames, so only finish once the input is gone too.
+    bool at_frame_boundary = result == 0;
+    bool consumed_everything = input.pos == input.size;
+
+    if (at_frame_boundary && consumed_everything && (flags & G_CONVERTER_INPUT_AT_END))
+        return G_CONVERTER_FINISHED;
+
+    if (input.pos == 0 && output.pos == 0) {
+        if (outbuf_size == 0) {
+            g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Need more output space");
+            return G_CONVERTER_ERROR;
+        }
+        if (flags & G_CONVERTER_INPUT_AT_END) {
+            g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Truncated zstd data");
+            return G_CONVERTER_ERROR;
+        }
+        g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Need more input");
+        return G_CONVERTER_ERROR;
+    }
+
+    if ((flags & G_CONVERTER_FLUSH) && consumed_everything && output.pos < output.size)
+        return G_CONVERTER_FLUSHED;
+
+    return G_CONVERTER_CONVERTED;
+}
+
+static void
+web_zstd_decompressor_reset (GConverter *converter)
+{
+    auto *self = WEB_ZSTD_DECOMPRESSOR (converter);
+    ZSTD_DCtx_reset (self->stream, ZSTD_reset_session_only);
+}
+
+static void
+web_zstd_decompressor_converter_init (GConverterIface *iface)
+{
+    iface->convert = web_zstd_decompressor_convert;
+    iface->reset = web_zstd_decompressor_reset;
+}
+
+static void
+web_zstd_decompressor_finalize (GObject *object)
+{
+    auto *self = WEB_ZSTD_DECOMPRESSOR (object);
+    ZSTD_freeDStream (self->stream);
+
+    G_OBJECT_CLASS (web_zstd_decompressor_parent_class)->finalize (object);
+}
+
+static void
+web_zstd_decompressor_class_init (WebZstdDecompressorClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    object_class->finalize = web_zstd_decompressor_finalize;
+}
+
+static void
+web_zstd_decompressor_init (WebZstdDecompressor *self)
+{
+    self->stream = ZSTD_createDStream ();
+    ZSTD_initDStream (self->stream);
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2023, Matthew Jakeman <mattjakemandev@gmail.com>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+// NOTE: libsoup's content decoder only knows about gzip, deflate and brotli.
+//       This fills in zstd ("Content-Encoding: zstd") as a GConverter we can wrap response streams in.
+#define WEB_TYPE_ZSTD_DECOMPRESSOR (web_zstd_decompressor_get_type())
+
+G_DECLARE_FINAL_TYPE (WebZstdDecompressor, web_zstd_decompressor, WEB, ZSTD_DECOMPRESSOR, GObject)
+
+GConverter *
+web_zstd_decompressor_new ();
+
+G_END_DECLS